@@ -0,0 +1,71 @@
+#include "phys/phys_arena.h"
+
+
+#define PHYS_ARENA_ALIGN  16
+
+u32 phys_alloc_count = 0;
+
+
+static uintptr_t phys_arena_align(uintptr_t p)
+{
+  return (p + (PHYS_ARENA_ALIGN -1)) & ~(uintptr_t)(PHYS_ARENA_ALIGN -1);
+}
+
+void phys_arena_free(phys_arena_t* a)
+{
+  for (u32 i = 0; i < arrlenu(a->extra_arr); ++i)
+  { ARRFREE(a->extra_arr[i]); }
+  ARRFREE(a->extra_arr);
+  ARRFREE(a->mem);
+  a->used       = 0;
+  a->extra_used = 0;
+  a->peak       = 0;
+}
+
+void phys_arena_reset(phys_arena_t* a)
+{
+  if (arrlenu(a->extra_arr) > 0)
+  {
+    for (u32 i = 0; i < arrlenu(a->extra_arr); ++i)
+    { ARRFREE(a->extra_arr[i]); }
+    arrsetlen(a->extra_arr, 0);
+
+    // grow to fit everything from last time, with some room, mem doesnt hold anything to keep
+    ARRFREE(a->mem);
+    PHYS_ARRSETLEN(a->mem, a->peak + a->peak / 2);
+  }
+  a->used       = 0;
+  a->extra_used = 0;
+  a->peak       = 0;
+}
+
+void* phys_arena_alloc(phys_arena_t* a, u32 bytes)
+{
+  uintptr_t base  = (uintptr_t)a->mem;
+  u32       start = (u32)(phys_arena_align(base + a->used) - base);
+  if (a->mem && start + bytes <= (u32)arrlenu(a->mem))
+  {
+    a->used = start + bytes;
+    a->peak = MAX(a->peak, a->used + a->extra_used);
+    return a->mem + start;
+  }
+
+  // doesnt fit, own block until the next reset
+  u8* block = NULL;
+  PHYS_ARRSETLEN(block, bytes + PHYS_ARENA_ALIGN);
+  PHYS_ARRPUT(a->extra_arr, block);
+  a->extra_used += bytes + PHYS_ARENA_ALIGN;
+  a->peak = MAX(a->peak, a->used + a->extra_used);
+  return (void*)phys_arena_align((uintptr_t)block);
+}
+
+u32 phys_arena_mark(phys_arena_t* a)
+{
+  return a->used;
+}
+
+void phys_arena_restore(phys_arena_t* a, u32 mark)
+{
+  ASSERT(mark <= a->used);
+  a->used = mark;   // extra blocks stay until the next reset, something before mark might use them
+}
@@ -0,0 +1,58 @@
+#ifndef PHYS_PHYS_ARENA_H
+#define PHYS_PHYS_ARENA_H
+
+#include "global/global.h"
+
+#include "stb/stb_ds.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: heap allocations done by phys since phys_init(), arena blocks and stb_ds arrs growing
+//       only counted where the PHYS_ARR... macros below are used, i.e. everything phys_update() touches
+extern u32 phys_alloc_count;
+
+// @DOC: true if putting n more items into stb_ds arr a has to reallocate it
+#define PHYS_ARR_GROWS(a, n)    (arrlenu(a) + (size_t)(n) > arrcap(a))
+// @DOC: same as arrput() / arrsetlen(), but count reallocations in phys_alloc_count
+//       stb_ds hashmaps also rebuild their index, which cant be counted, use phys_hash_t instead
+#define PHYS_ARRPUT(a, v)       (phys_alloc_count += PHYS_ARR_GROWS((a), 1), arrput((a), (v)))
+#define PHYS_ARRSETLEN(a, n)    (phys_alloc_count += ((size_t)(n) > arrcap(a)), arrsetlen((a), (n)))
+
+// @DOC: linear allocator for scratch memory only needed during one step or query
+//       allocs that dont fit get their own block, the next reset grows the arena to fit all of them
+//       so after a few steps it doesnt allocate anymore
+//       not thread safe, only alloc on the thread calling phys_update()
+typedef struct
+{
+  u8*  mem;         // stb_ds arr, its length is the arenas size
+  u32  used;        // bytes used in mem
+  u8** extra_arr;   // stb_ds arr of stb_ds arrs, allocs that didnt fit in mem, freed on reset
+  u32  extra_used;  // bytes in extra_arr
+  u32  peak;        // most bytes used at once since last reset, used + extra_used
+
+}phys_arena_t;
+#define PHYS_ARENA_T_INIT()   { .mem = NULL, .used = 0, .extra_arr = NULL, .extra_used = 0, .peak = 0 }
+
+// @DOC: free all memory of arena
+void phys_arena_free(phys_arena_t* a);
+// @DOC: free all allocs, grows mem if extra blocks were needed since last reset
+void phys_arena_reset(phys_arena_t* a);
+// @DOC: get bytes from the arena, 16 byte aligned, valid until the next reset / restore
+//       bytes: size of alloc, 0 returns a valid pointer as well
+void* phys_arena_alloc(phys_arena_t* a, u32 bytes);
+// @DOC: alloc arr of len items of type
+#define PHYS_ARENA_ALLOC_ARR(a, type, len)  ((type*)phys_arena_alloc((a), (u32)(sizeof(type) * (len))))
+
+// @DOC: get current position, pass to phys_arena_restore() to free everything allocated after
+u32 phys_arena_mark(phys_arena_t* a);
+// @DOC: free all allocs made after mark in mem, extra blocks only get freed by phys_arena_reset()
+//       mark: return of phys_arena_mark()
+void phys_arena_restore(phys_arena_t* a, u32 mark);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif
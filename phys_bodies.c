@@ -0,0 +1,50 @@
+#include "phys/phys_bodies.h"
+#include "phys/phys_arena.h"
+
+#include "stb/stb_ds.h"
+
+
+void phys_bodies_clear(phys_bodies_t* b)
+{
+  ARRFREE(b->pos);
+  ARRFREE(b->last_pos);
+  ARRFREE(b->velocity);
+  ARRFREE(b->force);
+  ARRFREE(b->drag);
+  ARRFREE(b->is_sleeping);
+  b->len = 0;
+}
+
+void phys_bodies_resize(phys_bodies_t* b, u32 len)
+{
+  PHYS_ARRSETLEN(b->pos,         len);
+  PHYS_ARRSETLEN(b->last_pos,    len);
+  PHYS_ARRSETLEN(b->velocity,    len);
+  PHYS_ARRSETLEN(b->force,       len);
+  PHYS_ARRSETLEN(b->drag,        len);
+  PHYS_ARRSETLEN(b->is_sleeping, len);
+  b->len = len;
+}
+
+void phys_bodies_init(phys_bodies_t* b, u32 i, vec3 pos)
+{
+  ASSERT(i < b->len);
+  vec3_copy(pos, b->pos[i]);
+  vec3_copy(pos, b->last_pos[i]);
+  vec3_copy(VEC3(0), b->velocity[i]);
+  vec3_copy(VEC3(0), b->force[i]);
+  b->drag[i]        = 0.0f;
+  b->is_sleeping[i] = 0;
+}
+
+void phys_bodies_move(phys_bodies_t* b, u32 from, u32 to)
+{
+  ASSERT(from < b->len && to < b->len);
+  if (from == to) { return; }
+  vec3_copy(b->pos[from],      b->pos[to]);
+  vec3_copy(b->last_pos[from], b->last_pos[to]);
+  vec3_copy(b->velocity[from], b->velocity[to]);
+  vec3_copy(b->force[from],    b->force[to]);
+  b->drag[to]        = b->drag[from];
+  b->is_sleeping[to] = b->is_sleeping[from];
+}
@@ -0,0 +1,82 @@
+#ifndef PHYS_PHYS_BODIES_H
+#define PHYS_PHYS_BODIES_H
+
+#include "global/global.h"
+#include "phys/phys_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: hot state of all objs, one packed arr per field, same idx as the objs in phys_objs
+//       this is the only copy, phys_obj_t doesnt have pos, velocity etc., see PHYS_OBJ_POS()
+//       the rigidbodies are the end of each arr, [phys_objs_static_len, len), so the dynamics
+//       stream through them without touching the phys_obj_t's
+typedef struct
+{
+  u32   len;          // all arrs have this length, stb_ds arrs
+
+  vec3* pos;          // position
+  vec3* last_pos;     // position, last step
+  vec3* velocity;     // only used by rigidbodies
+  vec3* force;        // only used by rigidbodies, also often called 'acceleration-accumulator'
+  f32*  drag;         // rigidbody_t.drag, times rigidbody_t.friction if colliding, set before the dynamics
+  u8*   is_sleeping;  // 1 if rigidbody_t.is_sleeping, set before the dynamics, gets skipped by them
+
+}phys_bodies_t;
+#define PHYS_BODIES_T_INIT()  { .len = 0 }
+
+// @DOC: state of the phys_obj_t's, see phys_world.c
+extern phys_obj_t*   phys_objs;
+extern phys_bodies_t phys_bodies;
+
+// @DOC: access the hot state of obj, obj has to be in phys_objs, i.e. from phys_get_obj()
+//       only valid until objs get added / removed, same as the obj pointer
+#define PHYS_OBJ_IDX(obj)       ((u32)((obj) - phys_objs))
+#define PHYS_OBJ_POS(obj)       (phys_bodies.pos[PHYS_OBJ_IDX(obj)])
+#define PHYS_OBJ_LAST_POS(obj)  (phys_bodies.last_pos[PHYS_OBJ_IDX(obj)])
+#define PHYS_OBJ_VELOCITY(obj)  (phys_bodies.velocity[PHYS_OBJ_IDX(obj)])
+#define PHYS_OBJ_FORCE(obj)     (phys_bodies.force[PHYS_OBJ_IDX(obj)])
+
+// @DOC: free all arrs
+void phys_bodies_clear(phys_bodies_t* b);
+// @DOC: set number of bodies, keeps the memory when shrinking
+void phys_bodies_resize(phys_bodies_t* b, u32 len);
+// @DOC: set body i to pos, not moving
+//       i:   idx of the body
+//       pos: gets copied into pos and last_pos
+void phys_bodies_init(phys_bodies_t* b, u32 i, vec3 pos);
+// @DOC: copy body from to to, overwrites whatever is at to, see phys_move_obj()
+void phys_bodies_move(phys_bodies_t* b, u32 from, u32 to);
+
+// @DOC: world aabb of obj's collider, pos, offset and cached bounds, see phys_obj_update_bounds()
+//       adds them in the same order as before the bounds were cached, so the aabb's stay the same
+//       box: (pos + scaled aabb) + offset, sphere: (pos + offset) +- radius
+INLINE void phys_obj_get_world_aabb(phys_obj_t* obj, vec3 min, vec3 max)
+{
+  vec3* b = obj->collider.bounds;
+  if (obj->collider.type == PHYS_COLLIDER_BOX)
+  {
+    vec3_add(b[0], PHYS_OBJ_POS(obj), min);
+    vec3_add(b[1], PHYS_OBJ_POS(obj), max);
+    vec3_add(min, obj->collider.offset, min);
+    vec3_add(max, obj->collider.offset, max);
+  }
+  else
+  {
+    vec3 pos;
+    vec3_add(PHYS_OBJ_POS(obj), obj->collider.offset, pos);
+    vec3_add(pos, b[0], min);
+    vec3_add(pos, b[1], max);
+  }
+}
+INLINE void phys_get_final_aabb(phys_obj_t* b, vec3* out)
+{
+  phys_obj_get_world_aabb(b, out[0], out[1]);
+}
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif
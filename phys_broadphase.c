@@ -0,0 +1,980 @@
+#include "phys/phys_broadphase.h"
+#include "phys/phys_arena.h"
+#include "phys/phys_hash.h"
+#include "phys/phys_types.h"
+
+#include "stb/stb_ds.h"
+
+
+// all proxies, unused ones are linked by next_free
+phys_proxy_t* phys_proxies = NULL;
+u32 phys_proxies_len = 0;
+int phys_proxies_free = -1;
+
+// aabb tree over rigidbody proxies, leafs user data is proxy idx
+phys_bvh_t phys_tree = PHYS_BVH_T_INIT();
+
+// static proxies, in phys_static_tree or phys_static_octree depending on static_type
+// built in one go and never refit, only rebuilt after static objs got added / removed / refreshed
+phys_static_type static_type = PHYS_STATIC_BVH;
+phys_bvh_t       phys_static_tree = PHYS_BVH_T_INIT();
+phys_octree_t    phys_static_octree = PHYS_OCTREE_T_INIT();
+bool             phys_static_tree_dirty = false;
+phys_bvh_build_item_t* static_build_arr = NULL;
+
+phys_broadphase_type broadphase_type = PHYS_BROADPHASE_BVH;
+
+// layers that dont collide, row per layer, bit per layer, kept symmetric
+// inverted so all 0 means everything collides
+u32 phys_layer_ignore[PHYS_LAYERS_MAX] = { 0 };
+
+// spatial hash grid over rigidbodies, only used with PHYS_BROADPHASE_GRID
+phys_grid_t phys_grid = PHYS_GRID_T_INIT();
+f32 grid_cell_size = 4.0f;
+
+// sweep-and-prune, rigidbody proxy idx's sorted by min x, see phys_proxy_t.sap_idx
+// stays sorted across frames, only moved proxies get swapped into place
+// new ones get put at the end and swapped into place on the next update
+// removed ones leave a -1 that keeps its min x, so the order stays valid, taken out once there are too many
+// only used with PHYS_BROADPHASE_SAP
+int* sap_arr = NULL;
+u32  sap_arr_len = 0;
+u32  sap_removed = 0;     // number of -1 in sap_arr
+f32  sap_width   = 0.0f;  // widest proxy on x, only shrinks when -1's get taken out
+// aabb's of sap_arr packed per axis, in sorted order, see phys_bvh_aabb_overlap_arr()
+// sap_min[0] is the sort key, removed ones have an empty aabb
+f32* sap_min[3] = { NULL, NULL, NULL };
+f32* sap_max[3] = { NULL, NULL, NULL };
+u32* sap_hits   = NULL;
+
+// proxies that moved, got added or had their layers changed since the last update
+// only they look for new pairs and check their pairs for ended ones, see phys_proxy_t.moved
+int* move_arr     = NULL;
+u32  move_arr_len = 0;
+bool move_all     = false;  // layer matrix changed, all proxies have to check their pairs
+
+// persistent cache of overlapping pairs, pair_map has the idx into pair_cache for both proxy idx's
+// pairs stay across updates, only new / lost overlaps change it
+// new pairs get appended, removing a pair moves the last one into its place
+// every proxy links its pairs, see phys_proxy_t.pairs
+phys_pair_t* pair_cache     = NULL;
+u32          pair_cache_len = 0;
+phys_hash_t  pair_map       = PHYS_HASH_T_INIT();
+
+// all pairs as obj idx's, pair_arr[i] is pair_cache[i], kept up to date with it
+// and pairs that started / stopped overlapping in last update
+phys_obj_combination_t* pair_arr = NULL;
+phys_obj_combination_t* pair_begin_arr = NULL;
+u32                     pair_begin_arr_len = 0;
+phys_obj_combination_t* pair_end_arr = NULL;
+u32                     pair_end_arr_len = 0;
+
+
+static void phys_broadphase_sap_clear();
+
+void phys_broadphase_clear()
+{
+  ARRFREE(phys_proxies);
+  phys_proxies_len  = 0;
+  phys_proxies_free = -1;
+  phys_bvh_clear(&phys_tree);
+  phys_bvh_clear(&phys_static_tree);
+  phys_octree_clear(&phys_static_octree);
+  phys_static_tree_dirty = false;
+  ARRFREE(static_build_arr);
+  phys_broadphase_sap_clear();
+  phys_grid_clear(&phys_grid);
+  ARRFREE(move_arr);
+  move_arr_len = 0;
+  move_all     = false;
+  ARRFREE(pair_cache);
+  pair_cache_len = 0;
+  phys_hash_clear(&pair_map);
+  ARRFREE(pair_arr);
+  ARRFREE(pair_begin_arr);
+  pair_begin_arr_len = 0;
+  ARRFREE(pair_end_arr);
+  pair_end_arr_len = 0;
+}
+
+// ---- pair cache ----
+
+static u64 phys_broadphase_pair_key(int proxy_idx0, int proxy_idx1)
+{
+  u32 lo = (u32)MIN(proxy_idx0, proxy_idx1);
+  u32 hi = (u32)MAX(proxy_idx0, proxy_idx1);
+  return ((u64)lo << 32) | (u64)hi;
+}
+// as obj idx's, rigidbody first
+static phys_obj_combination_t phys_broadphase_pair_objs(phys_pair_t* pair)
+{
+  phys_proxy_t* p0 = &phys_proxies[pair->proxy[0]];
+  phys_proxy_t* p1 = &phys_proxies[pair->proxy[1]];
+  phys_obj_combination_t c;
+  c.a = p0->is_dynamic ? p0->obj_idx : p1->obj_idx;
+  c.b = p0->is_dynamic ? p1->obj_idx : p0->obj_idx;
+  return c;
+}
+// layer matrix and both layer masks, checked before the pair cache
+static bool phys_broadphase_layers_collide(phys_proxy_t* p0, phys_proxy_t* p1)
+{
+  return !(phys_layer_ignore[p0->layer] & PHYS_LAYER_BIT(p1->layer)) &&
+         (p0->layer_mask & PHYS_LAYER_BIT(p1->layer)) &&
+         (p1->layer_mask & PHYS_LAYER_BIT(p0->layer));
+}
+// which of the pairs proxies proxy_idx is, 0 or 1
+static int phys_broadphase_pair_side(int pair_idx, int proxy_idx)
+{
+  return pair_cache[pair_idx].proxy[1] == proxy_idx;
+}
+// put pair in front of both its proxies pair lists
+static void phys_broadphase_link_pair(int idx)
+{
+  phys_pair_t* pair = &pair_cache[idx];
+  for (int s = 0; s < 2; ++s)
+  {
+    phys_proxy_t* p = &phys_proxies[pair->proxy[s]];
+    pair->prev[s] = -1;
+    pair->next[s] = p->pairs;
+    if (p->pairs >= 0) { pair_cache[p->pairs].prev[phys_broadphase_pair_side(p->pairs, pair->proxy[s])] = idx; }
+    p->pairs = idx;
+  }
+}
+// take pair out of both its proxies pair lists
+static void phys_broadphase_unlink_pair(int idx)
+{
+  phys_pair_t* pair = &pair_cache[idx];
+  for (int s = 0; s < 2; ++s)
+  {
+    int proxy_idx = pair->proxy[s];
+    int prev      = pair->prev[s];
+    int next      = pair->next[s];
+    if (prev >= 0) { pair_cache[prev].next[phys_broadphase_pair_side(prev, proxy_idx)] = next; }
+    else           { phys_proxies[proxy_idx].pairs = next; }
+    if (next >= 0) { pair_cache[next].prev[phys_broadphase_pair_side(next, proxy_idx)] = prev; }
+  }
+}
+// called for overlapping pairs found in an update with at least one moved proxy, adds it if its new
+// pairs whichs layers dont collide get dropped here, for every broadphase type
+static void phys_broadphase_touch_pair(int proxy_idx0, int proxy_idx1)
+{
+  if (!phys_broadphase_layers_collide(&phys_proxies[proxy_idx0], &phys_proxies[proxy_idx1])) { return; }
+
+  u64 key = phys_broadphase_pair_key(proxy_idx0, proxy_idx1);
+  if (phys_hash_get(&pair_map, key)) { return; }
+  phys_pair_t new_pair = { .key = key, .proxy = { MIN(proxy_idx0, proxy_idx1), MAX(proxy_idx0, proxy_idx1) } };
+  phys_obj_combination_t c = phys_broadphase_pair_objs(&new_pair);
+  phys_hash_put(&pair_map, key, pair_cache_len);
+  PHYS_ARRPUT(pair_cache, new_pair);
+  PHYS_ARRPUT(pair_arr, c);
+  phys_broadphase_link_pair((int)pair_cache_len++);
+
+  PHYS_ARRPUT(pair_begin_arr, c);
+  pair_begin_arr_len++;
+}
+// remove pair from pair_cache, the last pair takes its place
+static void phys_broadphase_remove_pair(u32 idx)
+{
+  phys_broadphase_unlink_pair((int)idx);
+  phys_hash_remove(&pair_map, pair_cache[idx].key);
+  u32 last = --pair_cache_len;
+  if (idx != last)
+  {
+    // point everything that linked to the last pair at its new place
+    phys_pair_t* pair = &pair_cache[idx];
+    *pair = pair_cache[last];
+    pair_arr[idx] = pair_arr[last];
+    *phys_hash_get(&pair_map, pair->key) = idx;
+    for (int s = 0; s < 2; ++s)
+    {
+      if (pair->prev[s] >= 0) { pair_cache[pair->prev[s]].next[phys_broadphase_pair_side(pair->prev[s], pair->proxy[s])] = (int)idx; }
+      else                    { phys_proxies[pair->proxy[s]].pairs = (int)idx; }
+      if (pair->next[s] >= 0) { pair_cache[pair->next[s]].prev[phys_broadphase_pair_side(pair->next[s], pair->proxy[s])] = (int)idx; }
+    }
+  }
+  arrsetlen(pair_cache, pair_cache_len);
+  arrsetlen(pair_arr, pair_cache_len);
+}
+// remove pairs of moved proxies that stopped overlapping or whichs layers dont collide anymore
+// pairs of two proxies that didnt move cant have changed
+static void phys_broadphase_end_pairs()
+{
+  for (u32 m = 0; m < move_arr_len; ++m)
+  {
+    int           idx = move_arr[m];
+    phys_proxy_t* p   = &phys_proxies[idx];
+    if (p->obj_idx < 0) { continue; }  // removed, its pairs are gone already
+
+    int i = p->pairs;
+    while (i >= 0)
+    {
+      phys_pair_t*  pair = &pair_cache[i];
+      int           side = phys_broadphase_pair_side(i, idx);
+      int           next = pair->next[side];
+      phys_proxy_t* q    = &phys_proxies[pair->proxy[!side]];
+      if (!phys_bvh_aabb_overlap(p->min, p->max, q->min, q->max) || !phys_broadphase_layers_collide(p, q))
+      {
+        PHYS_ARRPUT(pair_end_arr, pair_arr[i]);
+        pair_end_arr_len++;
+        phys_broadphase_remove_pair((u32)i);
+        // the last pair got moved into i
+        if (next == (int)pair_cache_len) { next = i; }
+      }
+      i = next;
+    }
+  }
+}
+// remove all pairs with proxy, no end events, the obj is gone
+static void phys_broadphase_remove_pairs(int proxy_idx)
+{
+  while (phys_proxies[proxy_idx].pairs >= 0)
+  { phys_broadphase_remove_pair((u32)phys_proxies[proxy_idx].pairs); }
+}
+
+// ---- sweep-and-prune ----
+
+static void phys_broadphase_sap_clear()
+{
+  ARRFREE(sap_arr);
+  sap_arr_len = 0;
+  sap_removed = 0;
+  sap_width   = 0.0f;
+  for (int a = 0; a < 3; ++a)
+  {
+    ARRFREE(sap_min[a]);
+    ARRFREE(sap_max[a]);
+  }
+  ARRFREE(sap_hits);
+}
+// put proxy at i, with its aabb
+static void phys_broadphase_sap_set(u32 i, int proxy_idx)
+{
+  phys_proxy_t* p = &phys_proxies[proxy_idx];
+  sap_arr[i] = proxy_idx;
+  p->sap_idx = i;
+  for (int a = 0; a < 3; ++a)
+  {
+    sap_min[a][i] = p->min[a];
+    sap_max[a][i] = p->max[a];
+  }
+  sap_width = MAX(sap_width, p->max[0] - p->min[0]);
+}
+static void phys_broadphase_sap_swap(u32 i, u32 j)
+{
+  int tmp = sap_arr[i];
+  sap_arr[i] = sap_arr[j];
+  sap_arr[j] = tmp;
+  if (sap_arr[i] >= 0) { phys_proxies[sap_arr[i]].sap_idx = i; }
+  if (sap_arr[j] >= 0) { phys_proxies[sap_arr[j]].sap_idx = j; }
+  for (int a = 0; a < 3; ++a)
+  {
+    f32 min = sap_min[a][i];
+    f32 max = sap_max[a][i];
+    sap_min[a][i] = sap_min[a][j];
+    sap_max[a][i] = sap_max[a][j];
+    sap_min[a][j] = min;
+    sap_max[a][j] = max;
+  }
+}
+static void phys_broadphase_sap_set_len(u32 len)
+{
+  PHYS_ARRSETLEN(sap_arr, len);
+  for (int a = 0; a < 3; ++a)
+  {
+    PHYS_ARRSETLEN(sap_min[a], len);
+    PHYS_ARRSETLEN(sap_max[a], len);
+  }
+  PHYS_ARRSETLEN(sap_hits, len);
+  sap_arr_len = len;
+}
+// put at the end, proxy is moved so it gets swapped into place on the next update
+// min x stays FLT_MAX until then, so the order stays valid if it gets removed before that
+static void phys_broadphase_sap_insert(int proxy_idx)
+{
+  phys_broadphase_sap_set_len(sap_arr_len +1);
+  u32 i = sap_arr_len -1;
+  sap_arr[i] = proxy_idx;
+  phys_proxies[proxy_idx].sap_idx = i;
+  for (int a = 0; a < 3; ++a)
+  {
+    sap_min[a][i] = FLT_MAX;
+    sap_max[a][i] = -FLT_MAX;
+  }
+}
+// leave a -1, keeps min x so the order stays valid, the empty aabb doesnt overlap anything
+static void phys_broadphase_sap_remove(int proxy_idx)
+{
+  u32 i = phys_proxies[proxy_idx].sap_idx;
+  sap_arr[i] = -1;
+  for (int a = 0; a < 3; ++a)
+  {
+    if (a > 0) { sap_min[a][i] = FLT_MAX; }
+    sap_max[a][i] = -FLT_MAX;
+  }
+  sap_removed++;
+}
+// take out all -1 left by phys_broadphase_sap_remove(), keeps the order
+static void phys_broadphase_sap_compact()
+{
+  u32 len = 0;
+  sap_width = 0.0f;
+  for (u32 i = 0; i < sap_arr_len; ++i)
+  {
+    if (sap_arr[i] >= 0) { phys_broadphase_sap_set(len++, sap_arr[i]); }
+  }
+  phys_broadphase_sap_set_len(len);
+  sap_removed = 0;
+}
+// by min x, for qsort()
+static int phys_broadphase_sap_cmp(const void* a, const void* b)
+{
+  f32 xa = phys_proxies[*(const int*)a].min[0];
+  f32 xb = phys_proxies[*(const int*)b].min[0];
+  return (xa > xb) - (xa < xb);
+}
+// sort all at once, after adding many
+static void phys_broadphase_sap_sort_all()
+{
+  u32 len = 0;
+  for (u32 i = 0; i < sap_arr_len; ++i)
+  {
+    if (sap_arr[i] >= 0) { sap_arr[len++] = sap_arr[i]; }
+  }
+  phys_broadphase_sap_set_len(len);
+  sap_removed = 0;
+  if (len <= 0) { return; }
+  qsort(sap_arr, len, sizeof(int), phys_broadphase_sap_cmp);
+  sap_width = 0.0f;
+  for (u32 i = 0; i < len; ++i)
+  { phys_broadphase_sap_set(i, sap_arr[i]); }
+}
+// swap moved proxies into place
+// objs move little between frames, so they only get swapped a few times
+static void phys_broadphase_sap_sort()
+{
+  // only worth a pass over all once a good part is -1
+  if (sap_removed > 32 && sap_removed * 4 > sap_arr_len) { phys_broadphase_sap_compact(); }
+
+  for (u32 m = 0; m < move_arr_len; ++m)
+  {
+    phys_proxy_t* p = &phys_proxies[move_arr[m]];
+    if (p->obj_idx < 0 || !p->is_dynamic) { continue; }
+    phys_broadphase_sap_set(p->sap_idx, move_arr[m]);
+  }
+
+  // proxies that didnt move stay in order, so once no moved proxy is out of order with its neighbours all are sorted
+  // moved proxies passing each other can stop one another early, so repeat until nothing got swapped
+  bool swapped = true;
+  while (swapped)
+  {
+    swapped = false;
+    for (u32 m = 0; m < move_arr_len; ++m)
+    {
+      phys_proxy_t* p = &phys_proxies[move_arr[m]];
+      if (p->obj_idx < 0 || !p->is_dynamic) { continue; }
+      u32 i = p->sap_idx;
+      while (i > 0 && sap_min[0][i -1] > sap_min[0][i])
+      {
+        phys_broadphase_sap_swap(i -1, i);
+        i--;
+        swapped = true;
+      }
+      while (i +1 < sap_arr_len && sap_min[0][i +1] < sap_min[0][i])
+      {
+        phys_broadphase_sap_swap(i, i +1);
+        i++;
+        swapped = true;
+      }
+    }
+  }
+}
+// first idx in [lo, hi) whichs min x is above x, or at least x if inclusive is false
+static u32 phys_broadphase_sap_search(f32 x, bool inclusive, u32 lo, u32 hi)
+{
+  while (lo < hi)
+  {
+    u32 mid = (lo + hi) / 2;
+    if (inclusive ? sap_min[0][mid] <= x : sap_min[0][mid] < x) { lo = mid + 1; }
+    else                                                         { hi = mid; }
+  }
+  return lo;
+}
+static void phys_broadphase_sap_find_pairs()
+{
+  phys_broadphase_sap_sort();
+
+  // only proxies overlapping on x can overlap at all
+  // proxies before p0 can start at most sap_width before it
+  for (u32 m = 0; m < move_arr_len; ++m)
+  {
+    int           p0_idx = move_arr[m];
+    phys_proxy_t* p0     = &phys_proxies[p0_idx];
+    if (p0->obj_idx < 0 || !p0->is_dynamic) { continue; }
+
+    u32 i  = p0->sap_idx;
+    u32 lo = phys_broadphase_sap_search(p0->min[0] - sap_width, false, 0, i);
+    u32 hi = phys_broadphase_sap_search(p0->max[0], true, i +1, sap_arr_len);
+
+    u32 hits_len = phys_bvh_aabb_overlap_arr(p0->min, p0->max, sap_min, sap_max, lo, i, sap_hits);
+    hits_len    += phys_bvh_aabb_overlap_arr(p0->min, p0->max, sap_min, sap_max, i +1, hi, sap_hits + hits_len);
+    for (u32 j = 0; j < hits_len; ++j)
+    {
+      int p1_idx = sap_arr[sap_hits[j]];
+      // pairs of two moved proxies get found from both sides, only keep one
+      if (p1_idx < 0 || (phys_proxies[p1_idx].moved && p1_idx < p0_idx)) { continue; }
+      phys_broadphase_touch_pair(p0_idx, p1_idx);
+    }
+  }
+}
+
+// ---- aabb tree ----
+
+static bool phys_broadphase_bvh_pair_callback(int proxy_idx, void* data)
+{
+  int           p0_idx = *(int*)data;
+  phys_proxy_t* p0     = &phys_proxies[p0_idx];
+  phys_proxy_t* p1     = &phys_proxies[proxy_idx];
+
+  // tree leafs are fattened, check the real aabb's
+  // pairs of two moved proxies get found from both sides, only keep one
+  if (proxy_idx == p0_idx || (p1->moved && proxy_idx < p0_idx)) { return true; }
+  if (!phys_bvh_aabb_overlap(p0->min, p0->max, p1->min, p1->max)) { return true; }
+
+  phys_broadphase_touch_pair(p0_idx, proxy_idx);
+  return true;
+}
+static void phys_broadphase_bvh_find_pairs()
+{
+  for (u32 m = 0; m < move_arr_len; ++m)
+  {
+    int proxy_idx = move_arr[m];
+    phys_proxy_t* p = &phys_proxies[proxy_idx];
+    if (p->obj_idx < 0 || !p->is_dynamic) { continue; }
+    phys_bvh_query_aabb(&phys_tree, p->min, p->max, phys_broadphase_bvh_pair_callback, &proxy_idx);
+  }
+}
+
+// ---- grid ----
+
+// pairs where neither proxy moved cant have changed
+static void phys_broadphase_grid_pair_callback(int proxy_idx0, int proxy_idx1, void* data)
+{
+  (void)data;
+  if (!phys_proxies[proxy_idx0].moved && !phys_proxies[proxy_idx1].moved) { return; }
+  phys_broadphase_touch_pair(proxy_idx0, proxy_idx1);
+}
+// pairs the grid cant find, p0 was too big for the grid
+static bool phys_broadphase_grid_tree_callback(int proxy_idx, void* data)
+{
+  int           p0_idx = *(int*)data;
+  phys_proxy_t* p0     = &phys_proxies[p0_idx];
+  phys_proxy_t* p1     = &phys_proxies[proxy_idx];
+
+  // neither in grid, gets found from both sides, only keep one
+  if (!p1->in_grid && proxy_idx <= p0_idx) { return true; }
+  if (!p0->moved && !p1->moved) { return true; }
+  if (!phys_bvh_aabb_overlap(p0->min, p0->max, p1->min, p1->max)) { return true; }
+
+  phys_broadphase_touch_pair(p0_idx, proxy_idx);
+  return true;
+}
+// the grid gets rebuilt from all rigidbodies, but only pairs with a moved proxy get touched
+static void phys_broadphase_grid_find_pairs(phys_obj_t* objs, u32 objs_len, u32 static_len)
+{
+  phys_grid_begin(&phys_grid, grid_cell_size);
+  for (u32 i = static_len; i < objs_len; ++i)
+  {
+    int proxy_idx = objs[i].proxy_idx;
+    if (proxy_idx < 0) { continue; }
+    phys_proxy_t* p = &phys_proxies[proxy_idx];
+    p->in_grid = phys_grid_add(&phys_grid, p->min, p->max, proxy_idx);
+  }
+  phys_grid_find_pairs(&phys_grid, phys_broadphase_grid_pair_callback, NULL);
+
+  // rigidbodies too big for the grid
+  for (u32 i = static_len; i < objs_len; ++i)
+  {
+    int proxy_idx = objs[i].proxy_idx;
+    if (proxy_idx < 0 || phys_proxies[proxy_idx].in_grid) { continue; }
+    phys_proxy_t* p = &phys_proxies[proxy_idx];
+    phys_bvh_query_aabb(&phys_tree, p->min, p->max, phys_broadphase_grid_tree_callback, &proxy_idx);
+  }
+}
+
+// ---- static ----
+
+static bool phys_broadphase_static_pair_callback(int proxy_idx, void* data)
+{
+  int           p0_idx = *(int*)data;
+  phys_proxy_t* p0     = &phys_proxies[p0_idx];
+  phys_proxy_t* p1     = &phys_proxies[proxy_idx];
+
+  // moved static v moved rigidbody gets found by the rigidbody
+  if (!p0->is_dynamic && p1->moved) { return true; }
+  if (!phys_bvh_aabb_overlap(p0->min, p0->max, p1->min, p1->max)) { return true; }
+
+  phys_broadphase_touch_pair(p0_idx, proxy_idx);
+  return true;
+}
+static void phys_broadphase_static_query_aabb(vec3 min, vec3 max, phys_bvh_query_callback* callback, void* data)
+{
+  if (static_type == PHYS_STATIC_OCTREE)
+  { phys_octree_query_aabb(&phys_static_octree, min, max, callback, data); }
+  else
+  { phys_bvh_query_aabb(&phys_static_tree, min, max, callback, data); }
+}
+static void phys_broadphase_static_query_ray(ray_t* ray, phys_bvh_query_callback* callback, void* data)
+{
+  if (static_type == PHYS_STATIC_OCTREE)
+  { phys_octree_query_ray(&phys_static_octree, ray, callback, data); }
+  else
+  { phys_bvh_query_ray(&phys_static_tree, ray, callback, data); }
+}
+// rigidbody v static, same for every broadphase type
+static f32 phys_broadphase_static_cast_aabb(ray_t* ray, vec3 ext, f32 max_dist, phys_bvh_ray_callback* callback, void* data)
+{
+  if (static_type == PHYS_STATIC_OCTREE)
+  { return phys_octree_cast_aabb(&phys_static_octree, ray, ext, max_dist, callback, data); }
+  else
+  { return phys_bvh_cast_aabb(&phys_static_tree, ray, ext, max_dist, callback, data); }
+}
+static void phys_broadphase_static_cast_ray_packet(phys_ray_packet_t* packet, phys_bvh_packet_callback* callback, void* data)
+{
+  if (static_type == PHYS_STATIC_OCTREE)
+  { phys_octree_cast_ray_packet(&phys_static_octree, packet, callback, data); }
+  else
+  { phys_bvh_cast_ray_packet(&phys_static_tree, packet, callback, data); }
+}
+// moved rigidbodies v static objs, and moved static objs v rigidbodies
+static void phys_broadphase_static_find_pairs()
+{
+  for (u32 m = 0; m < move_arr_len; ++m)
+  {
+    int proxy_idx = move_arr[m];
+    phys_proxy_t* p = &phys_proxies[proxy_idx];
+    if (p->obj_idx < 0) { continue; }
+    if (p->is_dynamic)
+    { phys_broadphase_static_query_aabb(p->min, p->max, phys_broadphase_static_pair_callback, &proxy_idx); }
+    else
+    { phys_bvh_query_aabb(&phys_tree, p->min, p->max, phys_broadphase_static_pair_callback, &proxy_idx); }
+  }
+}
+
+void phys_broadphase_set_static_type(phys_static_type type)
+{
+  if (type == static_type) { return; }
+  phys_bvh_clear(&phys_static_tree);
+  phys_octree_clear(&phys_static_octree);
+  static_type = type;
+  phys_static_tree_dirty = true;
+}
+phys_static_type phys_broadphase_get_static_type()
+{
+  return static_type;
+}
+void phys_broadphase_set_octree_params(int max_depth, u32 leaf_capacity)
+{
+  ASSERT(max_depth >= 0 && max_depth <= PHYS_OCTREE_MAX_DEPTH);
+  ASSERT(leaf_capacity > 0);
+  phys_static_octree.max_depth     = max_depth;
+  phys_static_octree.leaf_capacity = leaf_capacity;
+  if (static_type == PHYS_STATIC_OCTREE) { phys_static_tree_dirty = true; }
+}
+void phys_broadphase_get_static_stats(u32* node_count, int* depth)
+{
+  phys_broadphase_build_static();
+  if (static_type == PHYS_STATIC_OCTREE)
+  {
+    *node_count = phys_static_octree.nodes_len;
+    *depth      = phys_static_octree.depth;
+  }
+  else
+  {
+    *node_count = phys_static_tree.nodes_len;
+    *depth      = phys_bvh_get_height(&phys_static_tree);
+  }
+}
+
+void phys_broadphase_build_static()
+{
+  if (!phys_static_tree_dirty) { return; }
+
+  arrsetlen(static_build_arr, 0);
+  u32 len = 0;
+  for (u32 i = 0; i < phys_proxies_len; ++i)
+  {
+    phys_proxy_t* p = &phys_proxies[i];
+    if (p->obj_idx < 0 || p->is_dynamic) { continue; }
+    phys_bvh_build_item_t item;
+    vec3_copy(p->min, item.min);
+    vec3_copy(p->max, item.max);
+    item.user = (int)i;
+    PHYS_ARRPUT(static_build_arr, item);
+    len++;
+  }
+  if (static_type == PHYS_STATIC_OCTREE)
+  { phys_octree_build(&phys_static_octree, static_build_arr, len); }
+  else
+  { phys_bvh_build(&phys_static_tree, static_build_arr, len); }
+  phys_static_tree_dirty = false;
+}
+
+// ---- broadphase ----
+
+void phys_broadphase_set_type(phys_broadphase_type type)
+{
+  if (type == broadphase_type) { return; }
+
+  phys_broadphase_sap_clear();
+  phys_grid_clear(&phys_grid);
+  if (type == PHYS_BROADPHASE_SAP)
+  {
+    for (int i = 0; i < (int)phys_proxies_len; ++i)
+    {
+      if (phys_proxies[i].obj_idx < 0 || !phys_proxies[i].is_dynamic) { continue; }
+      phys_broadphase_sap_insert(i);
+    }
+    phys_broadphase_sap_sort_all();
+  }
+  broadphase_type = type;
+}
+phys_broadphase_type phys_broadphase_get_type()
+{
+  return broadphase_type;
+}
+void phys_broadphase_set_grid_cell_size(f32 cell_size)
+{
+  ASSERT(cell_size > 0.0f);
+  grid_cell_size = cell_size;
+}
+
+void phys_broadphase_obj_aabb(phys_obj_t* obj, vec3 min, vec3 max)
+{
+  phys_obj_get_world_aabb(obj, min, max);
+}
+
+// aabb at pos, grown to also cover the obj at last_pos
+static void phys_broadphase_calc_proxy_aabb(phys_obj_t* obj, phys_proxy_t* p)
+{
+  phys_broadphase_obj_aabb(obj, p->min, p->max);
+
+  vec3 delta;
+  vec3_sub(PHYS_OBJ_LAST_POS(obj), PHYS_OBJ_POS(obj), delta);
+  for (int i = 0; i < 3; ++i)
+  {
+    if (delta[i] < 0.0f) { p->min[i] += delta[i]; }
+    else                 { p->max[i] += delta[i]; }
+  }
+}
+
+// proxy gets checked for pair changes on the next update
+static void phys_broadphase_mark_moved(int proxy_idx)
+{
+  if (phys_proxies[proxy_idx].moved) { return; }
+  phys_proxies[proxy_idx].moved = true;
+  PHYS_ARRPUT(move_arr, proxy_idx);
+  move_arr_len++;
+}
+// aabb's not equal
+static bool phys_broadphase_aabb_changed(vec3 min0, vec3 max0, vec3 min1, vec3 max1)
+{
+  return min0[0] != min1[0] || min0[1] != min1[1] || min0[2] != min1[2] ||
+         max0[0] != max1[0] || max0[1] != max1[1] || max0[2] != max1[2];
+}
+
+// add proxy, without sap_arr, returns proxy idx or -1 if obj has no collider
+static int phys_broadphase_add_proxy(phys_obj_t* obj, int obj_idx)
+{
+  obj->proxy_idx = -1;
+  if (!PHYS_OBJ_HAS_COLLIDER(obj)) { return -1; }
+
+  // reuse unused proxy or make new one
+  // a reused proxy might still be in move_arr, keeps its moved
+  int idx = phys_proxies_free;
+  if (idx >= 0)
+  { phys_proxies_free = phys_proxies[idx].next_free; }
+  else
+  {
+    phys_proxy_t p = { .moved = false };
+    PHYS_ARRPUT(phys_proxies, p);
+    idx = (int)phys_proxies_len++;
+  }
+  phys_proxy_t* p = &phys_proxies[idx];
+  p->obj_idx    = obj_idx;
+  p->is_dynamic = PHYS_OBJ_HAS_RIGIDBODY(obj);
+  p->layer      = obj->layer;
+  p->layer_mask = obj->layer_mask;
+  p->in_grid    = false;
+  p->next_free  = -1;
+  p->tree_leaf  = -1;
+  p->pairs      = -1;
+  phys_broadphase_calc_proxy_aabb(obj, p);
+  obj->proxy_idx = idx;
+  phys_broadphase_mark_moved(idx);
+
+  if (!p->is_dynamic)
+  { phys_static_tree_dirty = true; }
+  else
+  { p->tree_leaf = phys_bvh_insert(&phys_tree, p->min, p->max, idx); }
+  return idx;
+}
+void phys_broadphase_add(phys_obj_t* obj, int obj_idx)
+{
+  int idx = phys_broadphase_add_proxy(obj, obj_idx);
+  if (idx >= 0 && phys_proxies[idx].is_dynamic && broadphase_type == PHYS_BROADPHASE_SAP)
+  { phys_broadphase_sap_insert(idx); }
+}
+void phys_broadphase_add_arr(phys_obj_t* objs, u32 start, u32 end)
+{
+  arrsetcap(phys_proxies, phys_proxies_len + (end - start));
+  bool sap = broadphase_type == PHYS_BROADPHASE_SAP;
+  for (u32 i = start; i < end; ++i)
+  {
+    int idx = phys_broadphase_add_proxy(&objs[i], (int)i);
+    if (sap && idx >= 0 && phys_proxies[idx].is_dynamic)
+    { phys_broadphase_sap_insert(idx); }
+  }
+  // sort once instead of sorting in each
+  if (sap) { phys_broadphase_sap_sort_all(); }
+}
+
+void phys_broadphase_remove(phys_obj_t* obj)
+{
+  int idx = obj->proxy_idx;
+  if (idx < 0) { return; }
+
+  if (!phys_proxies[idx].is_dynamic)
+  { phys_static_tree_dirty = true; }
+  else
+  {
+    if (broadphase_type == PHYS_BROADPHASE_SAP)
+    { phys_broadphase_sap_remove(idx); }
+    phys_bvh_remove(&phys_tree, phys_proxies[idx].tree_leaf);
+  }
+
+  phys_broadphase_remove_pairs(idx);
+  phys_proxies[idx].obj_idx   = -1;
+  phys_proxies[idx].tree_leaf = -1;
+  phys_proxies[idx].next_free = phys_proxies_free;
+  phys_proxies_free = idx;
+  obj->proxy_idx    = -1;
+}
+
+void phys_broadphase_set_obj_idx(phys_obj_t* obj, int obj_idx)
+{
+  int idx = obj->proxy_idx;
+  if (idx < 0) { return; }
+  phys_proxies[idx].obj_idx = obj_idx;
+  for (int i = phys_proxies[idx].pairs; i >= 0; i = pair_cache[i].next[phys_broadphase_pair_side(i, idx)])
+  { pair_arr[i] = phys_broadphase_pair_objs(&pair_cache[i]); }
+}
+
+void phys_broadphase_set_layers(phys_obj_t* obj)
+{
+  if (obj->proxy_idx < 0) { return; }
+  ASSERT(obj->layer < PHYS_LAYERS_MAX);
+  phys_proxies[obj->proxy_idx].layer      = obj->layer;
+  phys_proxies[obj->proxy_idx].layer_mask = obj->layer_mask;
+  phys_broadphase_mark_moved(obj->proxy_idx);
+}
+void phys_broadphase_set_layer_collision(u32 layer0, u32 layer1, bool collide)
+{
+  ASSERT(layer0 < PHYS_LAYERS_MAX && layer1 < PHYS_LAYERS_MAX);
+  if (collide)
+  {
+    phys_layer_ignore[layer0] &= ~PHYS_LAYER_BIT(layer1);
+    phys_layer_ignore[layer1] &= ~PHYS_LAYER_BIT(layer0);
+  }
+  else
+  {
+    phys_layer_ignore[layer0] |= PHYS_LAYER_BIT(layer1);
+    phys_layer_ignore[layer1] |= PHYS_LAYER_BIT(layer0);
+  }
+  move_all = true;
+}
+bool phys_broadphase_get_layer_collision(u32 layer0, u32 layer1)
+{
+  ASSERT(layer0 < PHYS_LAYERS_MAX && layer1 < PHYS_LAYERS_MAX);
+  return !(phys_layer_ignore[layer0] & PHYS_LAYER_BIT(layer1));
+}
+
+void phys_broadphase_refresh(phys_obj_t* obj)
+{
+  phys_obj_update_bounds(obj);
+  if (obj->proxy_idx < 0) { return; }
+  phys_proxy_t* p = &phys_proxies[obj->proxy_idx];
+  phys_broadphase_calc_proxy_aabb(obj, p);
+  phys_broadphase_mark_moved(obj->proxy_idx);
+  if (!p->is_dynamic)
+  { phys_static_tree_dirty = true; }
+  else
+  { phys_bvh_move(&phys_tree, p->tree_leaf, p->min, p->max); }
+}
+
+void phys_broadphase_update_aabbs(phys_obj_t* objs, u32 objs_len, u32 static_len)
+{
+  // only rigidbodies, static objs get refreshed with phys_broadphase_refresh()
+  // the tree only gets changed if an aabb left its fattened leaf
+  for (u32 i = static_len; i < objs_len; ++i)
+  {
+    phys_obj_t* obj = &objs[i];
+    if (obj->proxy_idx < 0) { continue; }
+    // keep last valid aabb, a nan would break every query in the tree
+    if (VEC3_NAN(PHYS_OBJ_POS(obj))) { continue; }
+
+    phys_proxy_t* p = &phys_proxies[obj->proxy_idx];
+    vec3 min, max;
+    vec3_copy(p->min, min);
+    vec3_copy(p->max, max);
+    phys_broadphase_calc_proxy_aabb(obj, p);
+    // sleeping objs dont move, so they never get checked for pair changes
+    if (!phys_broadphase_aabb_changed(min, max, p->min, p->max)) { continue; }
+    phys_broadphase_mark_moved(obj->proxy_idx);
+    phys_bvh_move(&phys_tree, p->tree_leaf, p->min, p->max);
+  }
+}
+
+void phys_broadphase_update(phys_obj_t* objs, u32 objs_len, u32 static_len)
+{
+  phys_broadphase_build_static();
+
+  // ---- update aabb's ----
+  // always, as dynamics moved them since the last update
+  phys_broadphase_update_aabbs(objs, objs_len, static_len);
+
+  if (move_all)
+  {
+    for (u32 i = 0; i < phys_proxies_len; ++i)
+    {
+      if (phys_proxies[i].obj_idx >= 0) { phys_broadphase_mark_moved((int)i); }
+    }
+    move_all = false;
+  }
+
+  // ---- find pairs ----
+  // only moved proxies, pairs between proxies that didnt move stay the same
+  arrsetlen(pair_begin_arr, 0);
+  pair_begin_arr_len = 0;
+  arrsetlen(pair_end_arr, 0);
+  pair_end_arr_len = 0;
+  phys_broadphase_end_pairs();
+  switch (broadphase_type)
+  {
+    case PHYS_BROADPHASE_BVH:
+      phys_broadphase_bvh_find_pairs();
+      break;
+    case PHYS_BROADPHASE_SAP:
+      phys_broadphase_sap_find_pairs();
+      break;
+    case PHYS_BROADPHASE_GRID:
+      phys_broadphase_grid_find_pairs(objs, objs_len, static_len);
+      break;
+  }
+  phys_broadphase_static_find_pairs();
+
+  for (u32 m = 0; m < move_arr_len; ++m)
+  { phys_proxies[move_arr[m]].moved = false; }
+  arrsetlen(move_arr, 0);
+  move_arr_len = 0;
+}
+
+phys_obj_combination_t* phys_broadphase_get_pairs(u32* len)
+{
+  *len = pair_cache_len;
+  return pair_arr;
+}
+phys_obj_combination_t* phys_broadphase_get_begin_pairs(u32* len)
+{
+  *len = pair_begin_arr_len;
+  return pair_begin_arr;
+}
+phys_obj_combination_t* phys_broadphase_get_end_pairs(u32* len)
+{
+  *len = pair_end_arr_len;
+  return pair_end_arr;
+}
+
+// ---- queries ----
+
+typedef struct
+{
+  phys_bvh_query_callback* callback;
+  void* data;
+  bool  stopped;  // callback returned false, dont query the next tree
+}phys_broadphase_query_t;
+
+// translate proxy idx to obj idx
+static bool phys_broadphase_query_callback(int proxy_idx, void* data)
+{
+  phys_broadphase_query_t* q = data;
+  q->stopped = !q->callback(phys_proxies[proxy_idx].obj_idx, q->data);
+  return !q->stopped;
+}
+
+void phys_broadphase_query_aabb(vec3 min, vec3 max, phys_bvh_query_callback* callback, void* data)
+{
+  phys_broadphase_build_static();
+  phys_broadphase_query_t q = { .callback = callback, .data = data, .stopped = false };
+  phys_broadphase_static_query_aabb(min, max, phys_broadphase_query_callback, &q);
+  if (q.stopped) { return; }
+  phys_bvh_query_aabb(&phys_tree, min, max, phys_broadphase_query_callback, &q);
+}
+
+void phys_broadphase_query_ray(ray_t* ray, phys_bvh_query_callback* callback, void* data)
+{
+  phys_broadphase_build_static();
+  phys_broadphase_query_t q = { .callback = callback, .data = data, .stopped = false };
+  phys_broadphase_static_query_ray(ray, phys_broadphase_query_callback, &q);
+  if (q.stopped) { return; }
+  phys_bvh_query_ray(&phys_tree, ray, phys_broadphase_query_callback, &q);
+}
+
+typedef struct
+{
+  phys_bvh_ray_callback* callback;
+  void* data;
+}phys_broadphase_cast_t;
+
+// translate proxy idx to obj idx
+static f32 phys_broadphase_cast_callback(int proxy_idx, f32 max_dist, void* data)
+{
+  phys_broadphase_cast_t* c = data;
+  return c->callback(phys_proxies[proxy_idx].obj_idx, max_dist, c->data);
+}
+
+void phys_broadphase_cast_ray(ray_t* ray, phys_bvh_ray_callback* callback, void* data)
+{
+  vec3 ext = { 0.0f, 0.0f, 0.0f };
+  phys_broadphase_cast_aabb(ray, ext, callback, data);
+}
+
+void phys_broadphase_cast_aabb(ray_t* ray, vec3 ext, phys_bvh_ray_callback* callback, void* data)
+{
+  phys_broadphase_build_static();
+  phys_broadphase_cast_t c = { .callback = callback, .data = data };
+  f32 max_dist = ray->len <= 0.0f ? FLT_MAX : ray->len;
+  max_dist = phys_broadphase_static_cast_aabb(ray, ext, max_dist, phys_broadphase_cast_callback, &c);
+  if (max_dist < 0.0f) { return; }
+  phys_bvh_cast_aabb(&phys_tree, ray, ext, max_dist, phys_broadphase_cast_callback, &c);
+}
+
+typedef struct
+{
+  phys_bvh_packet_callback* callback;
+  void* data;
+}phys_broadphase_cast_packet_t;
+
+// translate proxy idx to obj idx
+static void phys_broadphase_cast_packet_callback(int proxy_idx, int lanes, void* data)
+{
+  phys_broadphase_cast_packet_t* c = data;
+  c->callback(phys_proxies[proxy_idx].obj_idx, lanes, c->data);
+}
+
+void phys_broadphase_cast_ray_packet(phys_ray_packet_t* packet, phys_bvh_packet_callback* callback, void* data)
+{
+  ASSERT(!phys_static_tree_dirty);
+  phys_broadphase_cast_packet_t c = { .callback = callback, .data = data };
+  phys_broadphase_static_cast_ray_packet(packet, phys_broadphase_cast_packet_callback, &c);
+  phys_bvh_cast_ray_packet(&phys_tree, packet, phys_broadphase_cast_packet_callback, &c);
+}
@@ -0,0 +1,173 @@
+#ifndef PHYS_PHYS_BROADPHASE_H
+#define PHYS_PHYS_BROADPHASE_H
+
+#include "global/global.h"
+#include "phys/phys_types.h"
+#include "phys/phys_world.h"  // phys_obj_combination_t
+#include "phys/phys_bvh.h"
+#include "phys/phys_grid.h"
+#include "phys/phys_octree.h"
+#include "phys/phys_bodies.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: proxy of a phys_obj_t with a collider inside the broadphase
+//       the aabb covers the obj at last_pos and at pos,
+//       so the swept checks in phys_collision_check() still get their pairs
+typedef struct
+{
+  int  obj_idx;     // idx into phys_objs array in phys_world.c, -1 if proxy is unused
+  vec3 min;         // world aabb min
+  vec3 max;         // world aabb max
+  bool is_dynamic;  // obj has rigidbody, static v static pairs get skipped
+  u32  layer;       // phys_obj_t.layer, see phys_broadphase_set_layers()
+  u32  layer_mask;  // phys_obj_t.layer_mask
+  int  tree_leaf;   // idx of leaf in the rigidbody phys_bvh_t, -1 for static proxies
+  bool in_grid;     // got added to the grid, only used with PHYS_BROADPHASE_GRID
+  u32  sap_idx;     // idx in the sweep-and-prune arr, only used with PHYS_BROADPHASE_SAP
+  bool moved;       // aabb or layers changed since the last update, gets checked for new / ended pairs
+  int  pairs;       // first pair with this proxy in the pair cache, -1 if none, see phys_pair_t.next
+  int  next_free;   // next unused proxy, only valid if obj_idx is -1
+
+}phys_proxy_t;
+
+// @DOC: pair of overlapping proxies in the broadphase's pair cache
+//       stays in the cache as long as the proxies aabb's overlap
+typedef struct
+{
+  u64 key;      // both proxy idx's, lower one in the upper 32 bits
+  int proxy[2]; // proxy idx's, lower one first
+  int next[2];  // next pair in the pair list of proxy[i], -1 if last, see phys_proxy_t.pairs
+  int prev[2];  // previous pair in the pair list of proxy[i], -1 if first
+
+}phys_pair_t;
+
+// @DOC: free all broadphase memory, call when all phys objs get removed
+void phys_broadphase_clear();
+
+// @DOC: switch how pairs get found, can be called at any time
+//       type: PHYS_BROADPHASE_BVH is default
+void phys_broadphase_set_type(phys_broadphase_type type);
+// @DOC: get how pairs get found
+phys_broadphase_type phys_broadphase_get_type();
+// @DOC: set cell size used by PHYS_BROADPHASE_GRID, can be called at any time
+//       cell_size: should be about the size of the average rigidbody
+void phys_broadphase_set_grid_cell_size(f32 cell_size);
+
+// @DOC: add proxy for phys_obj_t, ignores objs without collider
+//       obj:     object to add, obj->proxy_idx gets set
+//       obj_idx: idx of obj in phys_objs array
+void phys_broadphase_add(phys_obj_t* obj, int obj_idx);
+// @DOC: add proxies for many objs, same as phys_broadphase_add() for each, but sorts sap_arr once
+//       objs:       arr of objs, i.e. phys_objs
+//       start, end: range of objs to add, [start, end), the idx in objs is the obj_idx
+void phys_broadphase_add_arr(phys_obj_t* objs, u32 start, u32 end);
+// @DOC: remove proxy of phys_obj_t, ignores objs without proxy
+//       obj: object to remove, obj->proxy_idx gets set to -1
+void phys_broadphase_remove(phys_obj_t* obj);
+// @DOC: tell broadphase the obj moved inside the phys_objs array
+//       obj:     object that moved, already at its new location
+//       obj_idx: new idx of obj in phys_objs array
+void phys_broadphase_set_obj_idx(phys_obj_t* obj, int obj_idx);
+// @DOC: tell broadphase the objs layer or layer_mask changed
+//       pairs that cant collide anymore end on the next update
+//       obj: object with changed phys_obj_t.layer / layer_mask
+void phys_broadphase_set_layers(phys_obj_t* obj);
+// @DOC: set if objs on layer0 and layer1 can collide, both ways, all can by default
+//       pairs between them never get found, so they never reach the narrowphase
+//       layer0, layer1: 0 - PHYS_LAYERS_MAX -1, can be the same
+//       collide:        false to never find pairs between them
+void phys_broadphase_set_layer_collision(u32 layer0, u32 layer1, bool collide);
+// @DOC: get if objs on layer0 and layer1 can collide, see phys_broadphase_set_layer_collision()
+bool phys_broadphase_get_layer_collision(u32 layer0, u32 layer1);
+
+// @DOC: recalc a proxies aabb, i.e. after changing collider, scale or moving a static obj
+//       static objs only get checked here, never in phys_broadphase_update()
+//       obj: object whichs proxy gets updated
+void phys_broadphase_refresh(phys_obj_t* obj);
+
+// @DOC: switch structure for static objs, gets rebuilt on next update or query
+//       type: PHYS_STATIC_BVH is default
+void phys_broadphase_set_static_type(phys_static_type type);
+// @DOC: get structure used for static objs
+phys_static_type phys_broadphase_get_static_type();
+// @DOC: set how the octree for PHYS_STATIC_OCTREE gets built, gets rebuilt on next update or query
+//       max_depth:     deepest level nodes get split to, max PHYS_OCTREE_MAX_DEPTH
+//       leaf_capacity: nodes with more objs than this get split
+void phys_broadphase_set_octree_params(int max_depth, u32 leaf_capacity);
+// @DOC: get size of structure for static objs, to tune it per level
+//       node_count: gets set to number of nodes
+//       depth:      gets set to the deepest nodes level, 0 for empty or only root
+void phys_broadphase_get_static_stats(u32* node_count, int* depth);
+
+// @DOC: build the structure over all static objs, if any got added, removed or refreshed since the last build
+//       gets called by phys_broadphase_update() and the queries,
+//       call after loading a level to not have the first frame build it
+void phys_broadphase_build_static();
+
+// @DOC: update aabb's of rigidbodies and find all overlapping pairs
+//       call after phys_dynamics_simulate() on all objs
+//       objs:       phys_objs array, static objs first, then rigidbodies
+//       objs_len:   length of objs
+//       static_len: number of static objs at the start of objs
+void phys_broadphase_update(phys_obj_t* objs, u32 objs_len, u32 static_len);
+// @DOC: update aabb's of rigidbodies in the tree, without finding pairs
+//       call after resolution moved them, so queries until the next phys_broadphase_update() see where they are
+//       same args as phys_broadphase_update()
+void phys_broadphase_update_aabbs(phys_obj_t* objs, u32 objs_len, u32 static_len);
+
+// @DOC: get all overlapping pairs, every pair once, after the last phys_broadphase_update()
+//       pairs are kept across updates, the order only changes when pairs begin / end
+//       new pairs get appended, ended ones get replaced by the last pair
+//       a always has a rigidbody, b might not
+//       a, b are idx's into phys_objs array
+//       len: gets set to arr's length
+phys_obj_combination_t* phys_broadphase_get_pairs(u32* len);
+// @DOC: get pairs that started overlapping in the last phys_broadphase_update()
+//       same layout as phys_broadphase_get_pairs()
+//       len: gets set to arr's length
+phys_obj_combination_t* phys_broadphase_get_begin_pairs(u32* len);
+// @DOC: get pairs that stopped overlapping in the last phys_broadphase_update()
+//       same layout as phys_broadphase_get_pairs(), pairs of removed objs dont show up
+//       len: gets set to arr's length
+phys_obj_combination_t* phys_broadphase_get_end_pairs(u32* len);
+
+// @DOC: call callback for every phys_obj_t whichs aabb overlaps the given aabb
+//       min, max: aabb to check against
+//       callback: gets called with idx into phys_objs array
+//       data:     gets passed to callback
+void phys_broadphase_query_aabb(vec3 min, vec3 max, phys_bvh_query_callback* callback, void* data);
+// @DOC: call callback for every phys_obj_t whichs aabb gets hit by ray
+//       ray:      ray->len <= 0.0f means infinite length
+//       callback: gets called with idx into phys_objs array
+//       data:     gets passed to callback
+void phys_broadphase_query_ray(ray_t* ray, phys_bvh_query_callback* callback, void* data);
+// @DOC: cast ray front to back through static and rigidbody trees, for closest hit queries
+//       see phys_bvh_cast_ray(), max_dist carries over from the static to the rigidbody tree
+//       ray:      ray->len <= 0.0f means infinite length, otherwise its the initial max dist
+//       callback: gets called with idx into phys_objs array, returns the new max dist
+//       data:     gets passed to callback
+void phys_broadphase_cast_ray(ray_t* ray, phys_bvh_ray_callback* callback, void* data);
+// @DOC: cast aabb front to back through static and rigidbody trees, same as phys_broadphase_cast_ray()
+//       ray: path of the aabb's center, ray->len same as phys_broadphase_cast_ray()
+//       ext: half extents of the aabb, see phys_bvh_cast_aabb()
+void phys_broadphase_cast_aabb(ray_t* ray, vec3 ext, phys_bvh_ray_callback* callback, void* data);
+// @DOC: cast all rays of packet through static and rigidbody trees, see phys_bvh_cast_ray_packet()
+//       doesnt build the static tree, so it can run on multiple threads, call phys_broadphase_build_static() first
+//       callback: gets called with idx into phys_objs array and the lanes that hit its aabb
+//       data:     gets passed to callback
+void phys_broadphase_cast_ray_packet(phys_ray_packet_t* packet, phys_bvh_packet_callback* callback, void* data);
+
+// @DOC: get world aabb of phys_obj_t with collider, box or sphere
+//       obj: object with collider
+//       min: gets set to aabb min
+//       max: gets set to aabb max
+void phys_broadphase_obj_aabb(phys_obj_t* obj, vec3 min, vec3 max);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif
@@ -0,0 +1,667 @@
+#include "phys/phys_bvh.h"
+#include "phys/phys_simd.h"
+#include "phys/phys_arena.h"
+
+#include "stb/stb_ds.h"
+#include <float.h>
+
+
+// ---- helpers ----
+
+static void phys_bvh_aabb_union(vec3 min0, vec3 max0, vec3 min1, vec3 max1, vec3 min_out, vec3 max_out)
+{
+  min_out[0] = MIN(min0[0], min1[0]);
+  min_out[1] = MIN(min0[1], min1[1]);
+  min_out[2] = MIN(min0[2], min1[2]);
+  max_out[0] = MAX(max0[0], max1[0]);
+  max_out[1] = MAX(max0[1], max1[1]);
+  max_out[2] = MAX(max0[2], max1[2]);
+}
+// surface area, used as cost when picking where to insert
+static f32 phys_bvh_aabb_area(vec3 min, vec3 max)
+{
+  f32 x = max[0] - min[0];
+  f32 y = max[1] - min[1];
+  f32 z = max[2] - min[2];
+  return 2.0f * (x * y + y * z + z * x);
+}
+static f32 phys_bvh_union_area(vec3 min0, vec3 max0, vec3 min1, vec3 max1)
+{
+  vec3 min, max;
+  phys_bvh_aabb_union(min0, max0, min1, max1, min, max);
+  return phys_bvh_aabb_area(min, max);
+}
+static int phys_bvh_alloc_node(phys_bvh_t* tree)
+{
+  int idx = tree->free;
+  if (idx >= 0)
+  { tree->free = tree->nodes[idx].parent; }
+  else
+  {
+    phys_bvh_node_t n;
+    PHYS_ARRPUT(tree->nodes, n);
+    idx = (int)tree->nodes_len++;
+  }
+  phys_bvh_node_t* n = &tree->nodes[idx];
+  n->parent = -1;
+  n->child0 = -1;
+  n->child1 = -1;
+  n->height = 0;
+  n->user   = -1;
+  return idx;
+}
+static void phys_bvh_free_node(phys_bvh_t* tree, int idx)
+{
+  tree->nodes[idx].parent = tree->free;
+  tree->nodes[idx].height = -1;
+  tree->free = idx;
+}
+
+// recalc aabb and height of branch from its children
+static void phys_bvh_fix_node(phys_bvh_t* tree, int idx)
+{
+  phys_bvh_node_t* n  = &tree->nodes[idx];
+  phys_bvh_node_t* c0 = &tree->nodes[n->child0];
+  phys_bvh_node_t* c1 = &tree->nodes[n->child1];
+  phys_bvh_aabb_union(c0->min, c0->max, c1->min, c1->max, n->min, n->max);
+  n->height = 1 + MAX(c0->height, c1->height);
+}
+
+// rotate a up if unbalanced, returns idx of node now at a's place
+static int phys_bvh_balance(phys_bvh_t* tree, int ia)
+{
+  phys_bvh_node_t* nodes = tree->nodes;
+  phys_bvh_node_t* a = &nodes[ia];
+  if (PHYS_BVH_NODE_IS_LEAF(a) || a->height < 2) { return ia; }
+
+  int ib = a->child0;
+  int ic = a->child1;
+  phys_bvh_node_t* b = &nodes[ib];
+  phys_bvh_node_t* c = &nodes[ic];
+
+  int balance = c->height - b->height;
+
+  // rotate c up
+  if (balance > 1)
+  {
+    int if_ = c->child0;
+    int ig  = c->child1;
+    phys_bvh_node_t* f = &nodes[if_];
+    phys_bvh_node_t* g = &nodes[ig];
+
+    c->child0 = ia;
+    c->parent = a->parent;
+    a->parent = ic;
+
+    if (c->parent >= 0)
+    {
+      if (nodes[c->parent].child0 == ia) { nodes[c->parent].child0 = ic; }
+      else                               { nodes[c->parent].child1 = ic; }
+    }
+    else { tree->root = ic; }
+
+    if (f->height > g->height)
+    {
+      c->child1 = if_;
+      a->child1 = ig;
+      g->parent = ia;
+    }
+    else
+    {
+      c->child1 = ig;
+      a->child1 = if_;
+      f->parent = ia;
+    }
+    phys_bvh_fix_node(tree, ia);
+    phys_bvh_fix_node(tree, ic);
+    return ic;
+  }
+
+  // rotate b up
+  if (balance < -1)
+  {
+    int id = b->child0;
+    int ie = b->child1;
+    phys_bvh_node_t* d = &nodes[id];
+    phys_bvh_node_t* e = &nodes[ie];
+
+    b->child0 = ia;
+    b->parent = a->parent;
+    a->parent = ib;
+
+    if (b->parent >= 0)
+    {
+      if (nodes[b->parent].child0 == ia) { nodes[b->parent].child0 = ib; }
+      else                               { nodes[b->parent].child1 = ib; }
+    }
+    else { tree->root = ib; }
+
+    if (d->height > e->height)
+    {
+      b->child1 = id;
+      a->child0 = ie;
+      e->parent = ia;
+    }
+    else
+    {
+      b->child1 = ie;
+      a->child0 = id;
+      d->parent = ia;
+    }
+    phys_bvh_fix_node(tree, ia);
+    phys_bvh_fix_node(tree, ib);
+    return ib;
+  }
+
+  return ia;
+}
+
+// walk from idx to root fixing aabb's and heights
+static void phys_bvh_fix_upwards(phys_bvh_t* tree, int idx)
+{
+  while (idx >= 0)
+  {
+    idx = phys_bvh_balance(tree, idx);
+    phys_bvh_fix_node(tree, idx);
+    idx = tree->nodes[idx].parent;
+  }
+}
+
+static void phys_bvh_insert_leaf(phys_bvh_t* tree, int leaf)
+{
+  if (tree->root < 0)
+  {
+    tree->root = leaf;
+    tree->nodes[leaf].parent = -1;
+    return;
+  }
+
+  // find best sibling, descend to the child with the lowest cost
+  vec3 leaf_min, leaf_max;
+  vec3_copy(tree->nodes[leaf].min, leaf_min);
+  vec3_copy(tree->nodes[leaf].max, leaf_max);
+  int idx = tree->root;
+  while (!PHYS_BVH_NODE_IS_LEAF(&tree->nodes[idx]))
+  {
+    phys_bvh_node_t* n  = &tree->nodes[idx];
+    phys_bvh_node_t* c0 = &tree->nodes[n->child0];
+    phys_bvh_node_t* c1 = &tree->nodes[n->child1];
+
+    f32 area          = phys_bvh_aabb_area(n->min, n->max);
+    f32 combined_area = phys_bvh_union_area(n->min, n->max, leaf_min, leaf_max);
+
+    // cost of making new parent for this node and the leaf
+    f32 cost = 2.0f * combined_area;
+    // min cost of pushing the leaf further down
+    f32 inheritance_cost = 2.0f * (combined_area - area);
+
+    f32 cost0 = phys_bvh_union_area(c0->min, c0->max, leaf_min, leaf_max) + inheritance_cost;
+    if (!PHYS_BVH_NODE_IS_LEAF(c0)) { cost0 -= phys_bvh_aabb_area(c0->min, c0->max); }
+    f32 cost1 = phys_bvh_union_area(c1->min, c1->max, leaf_min, leaf_max) + inheritance_cost;
+    if (!PHYS_BVH_NODE_IS_LEAF(c1)) { cost1 -= phys_bvh_aabb_area(c1->min, c1->max); }
+
+    if (cost < cost0 && cost < cost1) { break; }
+    idx = cost0 < cost1 ? n->child0 : n->child1;
+  }
+  int sibling = idx;
+
+  // new parent for sibling and leaf
+  int old_parent = tree->nodes[sibling].parent;
+  int new_parent = phys_bvh_alloc_node(tree); // can realloc nodes
+  phys_bvh_node_t* np = &tree->nodes[new_parent];
+  np->parent = old_parent;
+  np->child0 = sibling;
+  np->child1 = leaf;
+  tree->nodes[sibling].parent = new_parent;
+  tree->nodes[leaf].parent    = new_parent;
+
+  if (old_parent >= 0)
+  {
+    if (tree->nodes[old_parent].child0 == sibling) { tree->nodes[old_parent].child0 = new_parent; }
+    else                                           { tree->nodes[old_parent].child1 = new_parent; }
+  }
+  else { tree->root = new_parent; }
+
+  phys_bvh_fix_upwards(tree, new_parent);
+}
+
+static void phys_bvh_remove_leaf(phys_bvh_t* tree, int leaf)
+{
+  if (leaf == tree->root)
+  {
+    tree->root = -1;
+    return;
+  }
+
+  int parent       = tree->nodes[leaf].parent;
+  int grand_parent = tree->nodes[parent].parent;
+  int sibling      = tree->nodes[parent].child0 == leaf ? tree->nodes[parent].child1 : tree->nodes[parent].child0;
+
+  if (grand_parent >= 0)
+  {
+    // replace parent with sibling
+    if (tree->nodes[grand_parent].child0 == parent) { tree->nodes[grand_parent].child0 = sibling; }
+    else                                            { tree->nodes[grand_parent].child1 = sibling; }
+    tree->nodes[sibling].parent = grand_parent;
+    phys_bvh_free_node(tree, parent);
+    phys_bvh_fix_upwards(tree, grand_parent);
+  }
+  else
+  {
+    tree->root = sibling;
+    tree->nodes[sibling].parent = -1;
+    phys_bvh_free_node(tree, parent);
+  }
+}
+
+
+// ---- build ----
+
+// centroid * 2, no need to divide for comparing
+static f32 phys_bvh_build_center(phys_bvh_build_item_t* item, int axis)
+{
+  return item->min[axis] + item->max[axis];
+}
+// quickselect, puts the item with the k'th smallest center on axis at k
+// smaller ones before, bigger ones after
+static void phys_bvh_build_select(phys_bvh_build_item_t* items, int start, int end, int k, int axis)
+{
+  while (end - start > 1)
+  {
+    f32 pivot = phys_bvh_build_center(&items[(start + end) / 2], axis);
+    int i = start;
+    int j = end - 1;
+    while (i <= j)
+    {
+      while (phys_bvh_build_center(&items[i], axis) < pivot) { i++; }
+      while (phys_bvh_build_center(&items[j], axis) > pivot) { j--; }
+      if (i <= j)
+      {
+        phys_bvh_build_item_t tmp = items[i];
+        items[i] = items[j];
+        items[j] = tmp;
+        i++;
+        j--;
+      }
+    }
+    if      (k <= j) { end   = j + 1; }
+    else if (k >= i) { start = i; }
+    else             { return; }
+  }
+}
+static int phys_bvh_build_node(phys_bvh_t* tree, phys_bvh_build_item_t* items, int start, int end, int parent)
+{
+  int idx = phys_bvh_alloc_node(tree);
+  tree->nodes[idx].parent = parent;
+
+  if (end - start == 1)
+  {
+    phys_bvh_node_t* n = &tree->nodes[idx];
+    vec3_copy(items[start].min, n->min);
+    vec3_copy(items[start].max, n->max);
+    n->user = items[start].user;
+    return idx;
+  }
+
+  // split along the longest axis of the centers
+  vec3 min = {  FLT_MAX,  FLT_MAX,  FLT_MAX };
+  vec3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+  for (int i = start; i < end; ++i)
+  {
+    for (int a = 0; a < 3; ++a)
+    {
+      f32 c  = phys_bvh_build_center(&items[i], a);
+      min[a] = MIN(min[a], c);
+      max[a] = MAX(max[a], c);
+    }
+  }
+  int axis = 0;
+  if (max[1] - min[1] > max[axis] - min[axis]) { axis = 1; }
+  if (max[2] - min[2] > max[axis] - min[axis]) { axis = 2; }
+
+  int mid = (start + end) / 2;
+  phys_bvh_build_select(items, start, end, mid, axis);
+
+  int child0 = phys_bvh_build_node(tree, items, start, mid, idx);
+  int child1 = phys_bvh_build_node(tree, items, mid, end, idx);
+  tree->nodes[idx].child0 = child0;
+  tree->nodes[idx].child1 = child1;
+  phys_bvh_fix_node(tree, idx);
+  return idx;
+}
+
+// ---- tree ----
+
+void phys_bvh_clear(phys_bvh_t* tree)
+{
+  ARRFREE(tree->nodes);
+  tree->nodes_len = 0;
+  tree->root = -1;
+  tree->free = -1;
+}
+
+void phys_bvh_build(phys_bvh_t* tree, phys_bvh_build_item_t* items, u32 items_len)
+{
+  // keep the nodes memory, the static tree gets rebuilt whenever static objs change
+  arrsetlen(tree->nodes, 0);
+  tree->nodes_len = 0;
+  tree->root = -1;
+  tree->free = -1;
+  if (items_len <= 0) { return; }
+
+  // reserve all nodes at once
+  PHYS_ARRSETLEN(tree->nodes, items_len * 2 - 1);
+  arrsetlen(tree->nodes, 0);
+  tree->root = phys_bvh_build_node(tree, items, 0, (int)items_len, -1);
+}
+
+int phys_bvh_insert(phys_bvh_t* tree, vec3 min, vec3 max, int user)
+{
+  int leaf = phys_bvh_alloc_node(tree);
+  phys_bvh_node_t* n = &tree->nodes[leaf];
+  vec3_sub_f(min, PHYS_BVH_AABB_MARGIN, n->min);
+  vec3_add_f(max, PHYS_BVH_AABB_MARGIN, n->max);
+  n->user   = user;
+  n->height = 0;
+  phys_bvh_insert_leaf(tree, leaf);
+  return leaf;
+}
+
+void phys_bvh_remove(phys_bvh_t* tree, int leaf)
+{
+  ASSERT(leaf >= 0 && leaf < (int)tree->nodes_len);
+  ASSERT(PHYS_BVH_NODE_IS_LEAF(&tree->nodes[leaf]));
+  phys_bvh_remove_leaf(tree, leaf);
+  phys_bvh_free_node(tree, leaf);
+}
+
+bool phys_bvh_move(phys_bvh_t* tree, int leaf, vec3 min, vec3 max)
+{
+  phys_bvh_node_t* n = &tree->nodes[leaf];
+  if (phys_bvh_aabb_contains(n->min, n->max, min, max)) { return false; }
+
+  phys_bvh_remove_leaf(tree, leaf);
+  n = &tree->nodes[leaf];
+  vec3_sub_f(min, PHYS_BVH_AABB_MARGIN, n->min);
+  vec3_add_f(max, PHYS_BVH_AABB_MARGIN, n->max);
+  phys_bvh_insert_leaf(tree, leaf);
+  return true;
+}
+
+void phys_bvh_set_user(phys_bvh_t* tree, int leaf, int user)
+{
+  tree->nodes[leaf].user = user;
+}
+
+void phys_bvh_query_aabb(phys_bvh_t* tree, vec3 min, vec3 max, phys_bvh_query_callback* callback, void* data)
+{
+  if (tree->root < 0) { return; }
+
+  int stack[PHYS_BVH_STACK_MAX];
+  int stack_len = 0;
+  stack[stack_len++] = tree->root;
+  while (stack_len > 0)
+  {
+    phys_bvh_node_t* n = &tree->nodes[stack[--stack_len]];
+    if (!phys_bvh_aabb_overlap(n->min, n->max, min, max)) { continue; }
+
+    if (PHYS_BVH_NODE_IS_LEAF(n))
+    {
+      if (!callback(n->user, data)) { return; }
+    }
+    else
+    {
+      ASSERT(stack_len + 2 <= PHYS_BVH_STACK_MAX);
+      stack[stack_len++] = n->child0;
+      stack[stack_len++] = n->child1;
+    }
+  }
+}
+
+void phys_bvh_query_ray(phys_bvh_t* tree, ray_t* ray, phys_bvh_query_callback* callback, void* data)
+{
+  if (tree->root < 0) { return; }
+
+  vec3 inv_dir = { 1.0f / ray->dir[0], 1.0f / ray->dir[1], 1.0f / ray->dir[2] };
+  f32  max_dist = ray->len <= 0.0f ? FLT_MAX : ray->len;
+
+  int stack[PHYS_BVH_STACK_MAX];
+  int stack_len = 0;
+  stack[stack_len++] = tree->root;
+  while (stack_len > 0)
+  {
+    phys_bvh_node_t* n = &tree->nodes[stack[--stack_len]];
+    if (!phys_bvh_ray_v_aabb(ray->pos, inv_dir, max_dist, n->min, n->max)) { continue; }
+
+    if (PHYS_BVH_NODE_IS_LEAF(n))
+    {
+      if (!callback(n->user, data)) { return; }
+    }
+    else
+    {
+      ASSERT(stack_len + 2 <= PHYS_BVH_STACK_MAX);
+      stack[stack_len++] = n->child0;
+      stack[stack_len++] = n->child1;
+    }
+  }
+}
+
+f32 phys_bvh_cast_ray(phys_bvh_t* tree, ray_t* ray, f32 max_dist, phys_bvh_ray_callback* callback, void* data)
+{
+  vec3 ext = { 0.0f, 0.0f, 0.0f };
+  return phys_bvh_cast_aabb(tree, ray, ext, max_dist, callback, data);
+}
+
+f32 phys_bvh_cast_aabb(phys_bvh_t* tree, ray_t* ray, vec3 ext, f32 max_dist, phys_bvh_ray_callback* callback, void* data)
+{
+  if (tree->root < 0) { return max_dist; }
+
+  vec3 inv_dir = { 1.0f / ray->dir[0], 1.0f / ray->dir[1], 1.0f / ray->dir[2] };
+
+  // dist the ray enters each node, so nodes pushed before a closer hit can be skipped
+  int stack[PHYS_BVH_STACK_MAX];
+  f32 stack_dist[PHYS_BVH_STACK_MAX];
+  int stack_len = 0;
+  phys_bvh_node_t* root = &tree->nodes[tree->root];
+  f32 root_dist = phys_bvh_ray_v_aabb_ext_dist(ray->pos, inv_dir, max_dist, root->min, root->max, ext);
+  if (root_dist == FLT_MAX) { return max_dist; }
+  stack[stack_len]        = tree->root;
+  stack_dist[stack_len++] = root_dist;
+  while (stack_len > 0)
+  {
+    --stack_len;
+    if (stack_dist[stack_len] > max_dist) { continue; }
+    phys_bvh_node_t* n = &tree->nodes[stack[stack_len]];
+
+    if (PHYS_BVH_NODE_IS_LEAF(n))
+    {
+      max_dist = callback(n->user, max_dist, data);
+      if (max_dist < 0.0f) { return max_dist; }
+      continue;
+    }
+
+    int c0 = n->child0;
+    int c1 = n->child1;
+    f32 d0 = phys_bvh_ray_v_aabb_ext_dist(ray->pos, inv_dir, max_dist, tree->nodes[c0].min, tree->nodes[c0].max, ext);
+    f32 d1 = phys_bvh_ray_v_aabb_ext_dist(ray->pos, inv_dir, max_dist, tree->nodes[c1].min, tree->nodes[c1].max, ext);
+    if (d1 < d0) 
+    { 
+      int c = c0; c0 = c1; c1 = c; 
+      f32 d = d0; d0 = d1; d1 = d; 
+    }
+
+    // farther one first, so the closer one gets popped first
+    ASSERT(stack_len + 2 <= PHYS_BVH_STACK_MAX);
+    if (d1 != FLT_MAX) { stack[stack_len] = c1; stack_dist[stack_len++] = d1; }
+    if (d0 != FLT_MAX) { stack[stack_len] = c0; stack_dist[stack_len++] = d0; }
+  }
+  return max_dist;
+}
+
+void phys_ray_packet_init(phys_ray_packet_t* packet, ray_t* rays, u32 rays_len)
+{
+  ASSERT(rays_len <= PHYS_SIMD_WIDTH);
+  for (u32 l = 0; l < PHYS_SIMD_WIDTH; ++l)
+  {
+    ray_t* ray = l < rays_len ? &rays[l] : NULL;
+    for (int a = 0; a < 3; ++a)
+    {
+      packet->pos[a][l]      = ray ? ray->pos[a] : 0.0f;
+      packet->inv_dir[a][l]  = ray ? 1.0f / ray->dir[a] : 1.0f;
+      packet->parallel[a][l] = isinf(packet->inv_dir[a][l]);
+    }
+    packet->max_dist[l] = (!ray || ray->len <= 0.0f) ? FLT_MAX : ray->len;
+    packet->active[l]   = ray != NULL;
+    packet->rays[l]     = ray;
+  }
+}
+
+int phys_bvh_ray_packet_v_aabb(phys_ray_packet_t* packet, vec3 min, vec3 max, f32* entry)
+{
+  phys_f32x_t neg_max = PHYS_F32X_SET1(-FLT_MAX);
+  phys_f32x_t pos_max = PHYS_F32X_SET1( FLT_MAX);
+  phys_f32x_t tmin = neg_max;
+  phys_f32x_t tmax = pos_max;
+  for (int a = 0; a < 3; ++a)
+  {
+    phys_f32x_t pos   = PHYS_F32X_LOAD(packet->pos[a]);
+    phys_f32x_t inv   = PHYS_F32X_LOAD(packet->inv_dir[a]);
+    phys_f32x_t b_min = PHYS_F32X_SET1(min[a]);
+    phys_f32x_t b_max = PHYS_F32X_SET1(max[a]);
+    phys_f32x_t t1 = PHYS_F32X_MUL(PHYS_F32X_SUB(b_min, pos), inv);
+    phys_f32x_t t2 = PHYS_F32X_MUL(PHYS_F32X_SUB(b_max, pos), inv);
+    phys_f32x_t lo = PHYS_F32X_MIN(t1, t2);
+    phys_f32x_t hi = PHYS_F32X_MAX(t1, t2);
+
+    // parallel lanes only check if pos is inside the slab, same as phys_bvh_ray_v_aabb()
+    phys_maskx_t parallel = PHYS_MASKX_FROM_U8(packet->parallel[a]);
+    phys_maskx_t inside   = PHYS_MASKX_AND(PHYS_F32X_CMP_LE(b_min, pos), PHYS_F32X_CMP_LE(pos, b_max));
+    lo = PHYS_F32X_SELECT(parallel, PHYS_F32X_SELECT(inside, neg_max, pos_max), lo);
+    hi = PHYS_F32X_SELECT(parallel, PHYS_F32X_SELECT(inside, pos_max, neg_max), hi);
+
+    tmin = PHYS_F32X_MAX(tmin, lo);
+    tmax = PHYS_F32X_MIN(tmax, hi);
+  }
+
+  phys_maskx_t m = PHYS_MASKX_FROM_U8(packet->active);
+  m = PHYS_MASKX_AND(m, PHYS_F32X_CMP_LE(PHYS_F32X_SET1(0.0f), tmax));
+  m = PHYS_MASKX_AND(m, PHYS_F32X_CMP_LE(tmin, tmax));
+  m = PHYS_MASKX_AND(m, PHYS_F32X_CMP_LE(tmin, PHYS_F32X_LOAD(packet->max_dist)));
+  int lanes = PHYS_MASKX_BITS(m);
+
+  if (entry && lanes)
+  {
+    f32 dists[PHYS_SIMD_WIDTH];
+    PHYS_F32X_STORE(dists, tmin);
+    *entry = FLT_MAX;
+    for (int l = 0; l < PHYS_SIMD_WIDTH; ++l)
+    {
+      if (lanes & (1 << l)) { *entry = MIN(*entry, MAX(dists[l], 0.0f)); }
+    }
+  }
+  return lanes;
+}
+
+// furthest max_dist of all lanes, nodes entered past it cant be hit by any lane
+static f32 phys_ray_packet_max_dist(phys_ray_packet_t* packet)
+{
+  f32 max_dist = -1.0f;
+  for (int l = 0; l < PHYS_SIMD_WIDTH; ++l)
+  {
+    if (packet->active[l]) { max_dist = MAX(max_dist, packet->max_dist[l]); }
+  }
+  return max_dist;
+}
+
+void phys_bvh_cast_ray_packet(phys_bvh_t* tree, phys_ray_packet_t* packet, phys_bvh_packet_callback* callback, void* data)
+{
+  if (tree->root < 0) { return; }
+
+  // lanes that hit each node and the closest entry dist, set when pushed
+  int stack[PHYS_BVH_STACK_MAX];
+  int stack_lanes[PHYS_BVH_STACK_MAX];
+  f32 stack_dist[PHYS_BVH_STACK_MAX];
+  int stack_len = 0;
+  f32 root_dist = 0.0f;
+  int root_lanes = phys_bvh_ray_packet_v_aabb(packet, tree->nodes[tree->root].min, tree->nodes[tree->root].max, &root_dist);
+  if (!root_lanes) { return; }
+  stack[stack_len]         = tree->root;
+  stack_lanes[stack_len]   = root_lanes;
+  stack_dist[stack_len++]  = root_dist;
+  f32 max_dist = phys_ray_packet_max_dist(packet);
+  while (stack_len > 0)
+  {
+    --stack_len;
+    if (stack_dist[stack_len] > max_dist) { continue; }
+    phys_bvh_node_t* n = &tree->nodes[stack[stack_len]];
+
+    if (PHYS_BVH_NODE_IS_LEAF(n))
+    {
+      callback(n->user, stack_lanes[stack_len], data);
+      max_dist = phys_ray_packet_max_dist(packet);
+      continue;
+    }
+
+    int c0 = n->child0;
+    int c1 = n->child1;
+    f32 d0 = FLT_MAX;
+    f32 d1 = FLT_MAX;
+    int l0 = phys_bvh_ray_packet_v_aabb(packet, tree->nodes[c0].min, tree->nodes[c0].max, &d0);
+    int l1 = phys_bvh_ray_packet_v_aabb(packet, tree->nodes[c1].min, tree->nodes[c1].max, &d1);
+    if (!l0) { d0 = FLT_MAX; }
+    if (!l1) { d1 = FLT_MAX; }
+    if (d1 < d0) 
+    { 
+      int c = c0; c0 = c1; c1 = c; 
+      int l = l0; l0 = l1; l1 = l; 
+      f32 d = d0; d0 = d1; d1 = d; 
+    }
+
+    // farther one first, so the closer one gets popped first
+    ASSERT(stack_len + 2 <= PHYS_BVH_STACK_MAX);
+    if (l1) { stack[stack_len] = c1; stack_lanes[stack_len] = l1; stack_dist[stack_len++] = d1; }
+    if (l0) { stack[stack_len] = c0; stack_lanes[stack_len] = l0; stack_dist[stack_len++] = d0; }
+  }
+}
+
+int phys_bvh_get_height(phys_bvh_t* tree)
+{
+  if (tree->root < 0) { return 0; }
+  return tree->nodes[tree->root].height;
+}
+
+u32 phys_bvh_aabb_overlap_arr(vec3 min, vec3 max, f32** mins, f32** maxs, u32 start, u32 end, u32* out)
+{
+  phys_f32x_t q_min[3], q_max[3];
+  for (int a = 0; a < 3; ++a)
+  {
+    q_min[a] = PHYS_F32X_SET1(min[a]);
+    q_max[a] = PHYS_F32X_SET1(max[a]);
+  }
+
+  u32 len = 0;
+  u32 i   = start;
+  for (; i + PHYS_SIMD_WIDTH <= end; i += PHYS_SIMD_WIDTH)
+  {
+    phys_maskx_t m = PHYS_F32X_CMP_LE(q_min[0], PHYS_F32X_LOAD(maxs[0] + i));
+    m = PHYS_MASKX_AND(m, PHYS_F32X_CMP_LE(PHYS_F32X_LOAD(mins[0] + i), q_max[0]));
+    m = PHYS_MASKX_AND(m, PHYS_F32X_CMP_LE(q_min[1], PHYS_F32X_LOAD(maxs[1] + i)));
+    m = PHYS_MASKX_AND(m, PHYS_F32X_CMP_LE(PHYS_F32X_LOAD(mins[1] + i), q_max[1]));
+    m = PHYS_MASKX_AND(m, PHYS_F32X_CMP_LE(q_min[2], PHYS_F32X_LOAD(maxs[2] + i)));
+    m = PHYS_MASKX_AND(m, PHYS_F32X_CMP_LE(PHYS_F32X_LOAD(mins[2] + i), q_max[2]));
+    int bits = PHYS_MASKX_BITS(m);
+    for (u32 lane = 0; bits != 0; ++lane, bits >>= 1)
+    {
+      if (bits & 1) { out[len++] = i + lane; }
+    }
+  }
+  // rest, one at a time
+  for (; i < end; ++i)
+  {
+    if (min[0] <= maxs[0][i] && max[0] >= mins[0][i] &&
+        min[1] <= maxs[1][i] && max[1] >= mins[1][i] &&
+        min[2] <= maxs[2][i] && max[2] >= mins[2][i])
+    { out[len++] = i; }
+  }
+  return len;
+}
@@ -0,0 +1,225 @@
+#ifndef PHYS_PHYS_BVH_H
+#define PHYS_PHYS_BVH_H
+
+#include "global/global.h"
+#include "phys/phys_types.h"
+#include "phys/phys_simd.h"
+
+#include <float.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: how much leaf aabb's get grown, so objs can move a bit without changing the tree
+#define PHYS_BVH_AABB_MARGIN  0.2f
+// @DOC: max depth for traversing the tree, tree is kept balanced so this never gets reached
+#define PHYS_BVH_STACK_MAX    256
+
+// @DOC: node in phys_bvh_t, either leaf with user data or branch with two children
+typedef struct
+{
+  vec3 min;     // aabb min, fattened for leafs
+  vec3 max;     // aabb max, fattened for leafs
+  int  parent;  // parent node, or next free node if unused
+  int  child0;  // -1 for leafs
+  int  child1;  // -1 for leafs
+  int  height;  // 0 for leafs, -1 for unused nodes
+  int  user;    // user data of leafs, i.e. proxy idx
+
+}phys_bvh_node_t;
+#define PHYS_BVH_NODE_IS_LEAF(n)  ((n)->child0 < 0)
+
+// taken from: box2d's b2DynamicTree, "https://github.com/erincatto/box2d"
+// @DOC: dynamic aabb tree, balanced binary tree of aabb's
+//       leafs can be added, removed and moved at any time
+typedef struct
+{
+  phys_bvh_node_t* nodes;
+  u32 nodes_len;
+  int root;       // -1 if empty
+  int free;       // first unused node, -1 if none
+
+}phys_bvh_t;
+#define PHYS_BVH_T_INIT() \
+{                         \
+  .nodes     = NULL,      \
+  .nodes_len = 0,         \
+  .root      = -1,        \
+  .free      = -1,        \
+}
+
+// @DOC: PHYS_SIMD_WIDTH rays packed per axis, cast through a tree together
+//       see phys_ray_packet_init(), phys_bvh_cast_ray_packet()
+typedef struct
+{
+  f32 pos[3][PHYS_SIMD_WIDTH];
+  f32 inv_dir[3][PHYS_SIMD_WIDTH];  // 1 / ray dir
+  u8  parallel[3][PHYS_SIMD_WIDTH]; // 1 if ray dir is 0 on that axis
+  f32 max_dist[PHYS_SIMD_WIDTH];    // max dist along each ray, shrunk by the callback as hits get found
+  u8  active[PHYS_SIMD_WIDTH];      // 0 for lanes without a ray
+  ray_t* rays[PHYS_SIMD_WIDTH];     // ray of each lane, NULL if not active
+
+}phys_ray_packet_t;
+
+// @DOC: item for phys_bvh_build()
+typedef struct
+{
+  vec3 min;
+  vec3 max;
+  int  user;  // user data of leaf, i.e. proxy idx
+
+}phys_bvh_build_item_t;
+
+// @DOC: func type called for every leaf found by a query
+//       user: user data of leaf
+//       data: data passed to the query
+//       return false to stop the query
+typedef bool (phys_bvh_query_callback)(int user, void* data);
+// @DOC: func type called for every leaf hit by a ray cast, closest first
+//       user:     user data of leaf
+//       max_dist: current max dist along the ray
+//       data:     data passed to the cast
+//       return new max dist, i.e. dist of a hit, to skip everything further away
+//       or max_dist to keep going, < 0 to stop the cast
+typedef f32 (phys_bvh_ray_callback)(int user, f32 max_dist, void* data);
+// @DOC: func type called for every leaf hit by a ray packet
+//       user:  user data of leaf
+//       lanes: bit per lane of phys_ray_packet_t whichs ray hit the leafs aabb
+//       data:  data passed to the cast
+//       shrink phys_ray_packet_t.max_dist of lanes with a hit, to skip everything further away
+typedef void (phys_bvh_packet_callback)(int user, int lanes, void* data);
+
+// @DOC: free all memory of tree and reset it
+void phys_bvh_clear(phys_bvh_t* tree);
+
+// @DOC: clear tree and build it from all items at once, splitting at the median top-down
+//       leafs dont get fattened, meant for trees that never change after, i.e. static objs
+//       items:     gets reordered
+//       items_len: length of items
+void phys_bvh_build(phys_bvh_t* tree, phys_bvh_build_item_t* items, u32 items_len);
+
+// @DOC: add leaf to tree
+//       min, max: tight aabb, gets fattened by PHYS_BVH_AABB_MARGIN
+//       user:     user data for leaf, i.e. proxy idx
+//       returns idx of leaf node
+int phys_bvh_insert(phys_bvh_t* tree, vec3 min, vec3 max, int user);
+// @DOC: remove leaf from tree
+//       leaf: idx returned by phys_bvh_insert()
+void phys_bvh_remove(phys_bvh_t* tree, int leaf);
+// @DOC: move leaf to new aabb, only changes tree if aabb left the fattened leaf aabb
+//       leaf:     idx returned by phys_bvh_insert()
+//       min, max: new tight aabb
+//       returns true if the leaf got re-inserted
+bool phys_bvh_move(phys_bvh_t* tree, int leaf, vec3 min, vec3 max);
+// @DOC: set user data of leaf
+void phys_bvh_set_user(phys_bvh_t* tree, int leaf, int user);
+
+// @DOC: call callback for every leaf overlapping aabb
+//       min, max: aabb to check against
+//       callback: gets called with every leafs user data
+//       data:     gets passed to callback
+void phys_bvh_query_aabb(phys_bvh_t* tree, vec3 min, vec3 max, phys_bvh_query_callback* callback, void* data);
+// @DOC: call callback for every leaf whichs aabb gets hit by ray
+//       ray:      ray->len <= 0.0f means infinite length
+//       callback: gets called with every leafs user data
+//       data:     gets passed to callback
+void phys_bvh_query_ray(phys_bvh_t* tree, ray_t* ray, phys_bvh_query_callback* callback, void* data);
+// @DOC: cast ray through tree front to back, for closest hit queries
+//       children get visited closest first, nodes past max_dist get skipped
+//       ray:      ray->len gets ignored, use max_dist
+//       max_dist: initial max dist along the ray, FLT_MAX for infinite
+//       callback: gets called with every hit leafs user data, returns the new max_dist
+//       data:     gets passed to callback
+//       returns the last max_dist
+f32 phys_bvh_cast_ray(phys_bvh_t* tree, ray_t* ray, f32 max_dist, phys_bvh_ray_callback* callback, void* data);
+// @DOC: cast aabb through tree front to back, same as phys_bvh_cast_ray()
+//       every node gets grown by ext, so leafs the swept aabb touches get visited
+//       ray: path of the aabb's center
+//       ext: half extents of the aabb, i.e. radius on every axis for a sphere
+f32 phys_bvh_cast_aabb(phys_bvh_t* tree, ray_t* ray, vec3 ext, f32 max_dist, phys_bvh_ray_callback* callback, void* data);
+
+// @DOC: fill packet with up to PHYS_SIMD_WIDTH rays, other lanes are inactive
+//       rays:     ray->len <= 0.0f means infinite length, otherwise its the lanes max_dist
+//       rays_len: number of rays, at most PHYS_SIMD_WIDTH
+void phys_ray_packet_init(phys_ray_packet_t* packet, ray_t* rays, u32 rays_len);
+// @DOC: slab test of all rays in packet against one aabb, PHYS_SIMD_WIDTH at a time
+//       same result as phys_bvh_ray_v_aabb() for each lane
+//       entry: NULL or gets set to the closest dist any hitting ray enters the aabb
+//       returns bit per lane that hit, inactive lanes never hit
+int phys_bvh_ray_packet_v_aabb(phys_ray_packet_t* packet, vec3 min, vec3 max, f32* entry);
+// @DOC: cast all rays of packet through tree together, front to back
+//       same as phys_bvh_cast_ray() for every lane, nodes get tested once for all lanes
+//       packet:   max_dist of each lane gets shrunk by callback
+//       callback: gets called with every hit leafs user data and the lanes that hit it
+//       data:     gets passed to callback
+void phys_bvh_cast_ray_packet(phys_bvh_t* tree, phys_ray_packet_t* packet, phys_bvh_packet_callback* callback, void* data);
+
+// @DOC: get height of tree, 0 for empty or single leaf
+int phys_bvh_get_height(phys_bvh_t* tree);
+
+// @DOC: test one aabb against packed aabb's, PHYS_SIMD_WIDTH at a time, see phys_simd.h
+//       same result as phys_bvh_aabb_overlap() for each of them
+//       min, max:   aabb to test
+//       mins, maxs: packed aabb's, one f32 arr per axis
+//       start, end: range of aabb's to test, [start, end)
+//       out:        gets the idx's of the overlapping aabb's, needs space for end - start idx's
+//       returns number of idx's written to out
+u32 phys_bvh_aabb_overlap_arr(vec3 min, vec3 max, f32** mins, f32** maxs, u32 start, u32 end, u32* out);
+
+// --- inline funcs ---
+
+INLINE bool phys_bvh_aabb_overlap(vec3 min0, vec3 max0, vec3 min1, vec3 max1)
+{
+  return min0[0] <= max1[0] && max0[0] >= min1[0] &&
+         min0[1] <= max1[1] && max0[1] >= min1[1] &&
+         min0[2] <= max1[2] && max0[2] >= min1[2];
+}
+INLINE bool phys_bvh_aabb_contains(vec3 min0, vec3 max0, vec3 min1, vec3 max1)
+{
+  return min0[0] <= min1[0] && max0[0] >= max1[0] &&
+         min0[1] <= min1[1] && max0[1] >= max1[1] &&
+         min0[2] <= min1[2] && max0[2] >= max1[2];
+}
+// slab test, axes the ray is parallel to only check if pos is inside the slab
+// otherwise pos on the slab's plane would give 0 * inf = nan
+//   inv_dir:  1 / ray dir
+//   max_dist: max dist along the ray
+//   returns dist along the ray where it enters the aabb, 0 if pos is inside, FLT_MAX if missed
+INLINE f32 phys_bvh_ray_v_aabb_dist(vec3 pos, vec3 inv_dir, f32 max_dist, vec3 min, vec3 max)
+{
+  f32 tmin = -FLT_MAX;
+  f32 tmax =  FLT_MAX;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (isinf(inv_dir[i]))
+    {
+      if (pos[i] < min[i] || pos[i] > max[i]) { return FLT_MAX; }
+      continue;
+    }
+    f32 t1 = (min[i] - pos[i]) * inv_dir[i];
+    f32 t2 = (max[i] - pos[i]) * inv_dir[i];
+    tmin = MAX(tmin, MIN(t1, t2));
+    tmax = MIN(tmax, MAX(t1, t2));
+  }
+
+  if (tmax < 0.0f || tmin > tmax || tmin > max_dist) { return FLT_MAX; }
+  return MAX(tmin, 0.0f);
+}
+// same as phys_bvh_ray_v_aabb_dist(), aabb grown by ext on every side
+INLINE f32 phys_bvh_ray_v_aabb_ext_dist(vec3 pos, vec3 inv_dir, f32 max_dist, vec3 min, vec3 max, vec3 ext)
+{
+  vec3 ext_min = { min[0] - ext[0], min[1] - ext[1], min[2] - ext[2] };
+  vec3 ext_max = { max[0] + ext[0], max[1] + ext[1], max[2] + ext[2] };
+  return phys_bvh_ray_v_aabb_dist(pos, inv_dir, max_dist, ext_min, ext_max);
+}
+INLINE bool phys_bvh_ray_v_aabb(vec3 pos, vec3 inv_dir, f32 max_dist, vec3 min, vec3 max)
+{
+  return phys_bvh_ray_v_aabb_dist(pos, inv_dir, max_dist, min, max) != FLT_MAX;
+}
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif
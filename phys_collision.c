@@ -6,8 +6,7 @@
 
 collision_info_t phys_collision_check(phys_obj_t* obj0, phys_obj_t* obj1)
 {
-	collision_info_t c;
-	c.collision = false;
+	collision_info_t c = COLLISION_INFO_T_INIT();
 	if (!PHYS_OBJ_HAS_COLLIDER(obj0) || !PHYS_OBJ_HAS_COLLIDER(obj1)) { return c; }
 
   // ERR_PHYS_OBJ_T_NAN(obj0);
@@ -27,8 +26,7 @@ collision_info_t phys_collision_check(phys_obj_t* obj0, phys_obj_t* obj1)
     
     // if obj hasnt moved enough dont do test bc. normal test gets done before
     // this is just for tunneling
-    collision_info_t swept;
-    swept.collision = false;
+    collision_info_t swept = COLLISION_INFO_T_INIT();
 
     // get smallest length of aabb's, as min dist travelled by obj for swept check
     f32 obj0_min = phys_aabb_smallest_side(obj0->collider.box.aabb);
@@ -36,9 +34,9 @@ collision_info_t phys_collision_check(phys_obj_t* obj0, phys_obj_t* obj1)
     f32 min_dist = obj0_min <= obj1_min ? obj0_min : obj1_min;
     min_dist *= 0.25f; // 0.5f;  // @NOTE: 0.5f should be enough but this is more precise prob.
   
-    if ( !c.collision && vec3_distance(obj0->pos, obj0->last_pos) > min_dist) // 0.1f ) // hasnt moved since last frame
+    if ( !c.collision && vec3_distance(PHYS_OBJ_POS(obj0), PHYS_OBJ_LAST_POS(obj0)) > min_dist) // 0.1f ) // hasnt moved since last frame
     { 
-      // debug_draw_sphere_register(obj0->pos, 0.1f, RGB_F(1, 0, 0));
+      // debug_draw_sphere_register(PHYS_OBJ_POS(obj0), 0.1f, RGB_F(1, 0, 0));
       swept = phys_collision_check_aabb_v_aabb_swept(obj0, obj1); 
     }
     if (swept.collision) { c = swept; }
@@ -63,17 +61,16 @@ collision_info_t phys_collision_check(phys_obj_t* obj0, phys_obj_t* obj1)
     
     // if obj hasnt moved enough dont do test bc. normal test gets done before
     // this is just for tunneling
-    collision_info_t swept;
-    swept.collision = false;
+    collision_info_t swept = COLLISION_INFO_T_INIT();
 
     // get smallest length of aabb's or radius, as min dist travelled by obj for swept check
     f32 box_min    = phys_aabb_smallest_side(box->collider.box.aabb) * 0.25f;
-    f32 sphere_min = sphere->collider.sphere.radius * ((sphere->scl[0] + sphere->scl[1] + sphere->scl[2]) * 0.33f);
+    f32 sphere_min = sphere->collider.bounds_radius;
     f32 min_dist   = MIN(box_min, sphere_min);
   
-    if ( !c.collision && vec3_distance(sphere->pos, sphere->last_pos) > min_dist) // 0.1f ) // hasnt moved since last frame
+    if ( !c.collision && vec3_distance(PHYS_OBJ_POS(sphere), PHYS_OBJ_LAST_POS(sphere)) > min_dist) // 0.1f ) // hasnt moved since last frame
     { 
-      // debug_draw_sphere_register(box->pos, 0.1f, RGB_F(1, 0, 0));
+      // debug_draw_sphere_register(PHYS_OBJ_POS(box), 0.1f, RGB_F(1, 0, 0));
 	    swept = phys_collision_check_aabb_v_sphere_swept(box, sphere, obj0_is_sphere);   // true: switch, s is first obj  
     }
     if (swept.collision) { c = swept; }
@@ -87,17 +84,16 @@ collision_info_t phys_collision_check(phys_obj_t* obj0, phys_obj_t* obj1)
 
 collision_info_t phys_collision_check_sphere_v_sphere(phys_obj_t* s0, phys_obj_t* s1)
 {
-	collision_info_t info;
-  info.collision = false;
+	collision_info_t info = COLLISION_INFO_T_INIT();
 	
   vec3 pos0 = VEC3_INIT(0);
 	vec3 pos1 = VEC3_INIT(0);	
-  vec3_add(s0->pos, s0->collider.offset, pos0);
-	vec3_add(s1->pos, s1->collider.offset, pos1);
+  vec3_add(PHYS_OBJ_POS(s0), s0->collider.offset, pos0);
+	vec3_add(PHYS_OBJ_POS(s1), s1->collider.offset, pos1);
 	
 
-  f32 radius0 = s0->collider.sphere.radius * ((s0->scl[0] + s0->scl[1] + s0->scl[2]) * 0.33f);
-  f32 radius1 = s1->collider.sphere.radius * ((s1->scl[0] + s1->scl[1] + s1->scl[2]) * 0.33f);
+  f32 radius0 = s0->collider.bounds_radius;
+  f32 radius1 = s1->collider.bounds_radius;
 
   info.depth =  vec3_distance(pos0, pos1);
 	info.depth -= (radius0 + radius1);
@@ -119,20 +115,18 @@ collision_info_t phys_collision_check_sphere_v_sphere_swept(phys_obj_t* s0, phys
   // this way only one raycast is required
   // raycast is from s0 last pos toward s0 current pos
 	
-  collision_info_t info;
-  info.collision = false;
+  collision_info_t info = COLLISION_INFO_T_INIT();
 	
   vec3 pos0      = VEC3_INIT(0);  // current s0 pos
   vec3 last_pos0 = VEC3_INIT(0);  // s0 pos last frame
 	vec3 pos1      = VEC3_INIT(0);	// current s1 pos
-  vec3_add(s0->pos,      s0->collider.offset, pos0);
-  vec3_add(s0->last_pos, s0->collider.offset, last_pos0);
-	vec3_add(s1->pos,      s1->collider.offset, pos1);
+  vec3_add(PHYS_OBJ_POS(s0),      s0->collider.offset, pos0);
+  vec3_add(PHYS_OBJ_LAST_POS(s0), s0->collider.offset, last_pos0);
+	vec3_add(PHYS_OBJ_POS(s1),      s1->collider.offset, pos1);
 	
 
   // s0's and s1's radii combined
-  f32 radius = s0->collider.sphere.radius * ((s0->scl[0] + s0->scl[1] + s0->scl[2]) * 0.33f) +
-               s1->collider.sphere.radius * ((s1->scl[0] + s1->scl[1] + s1->scl[2]) * 0.33f);
+  f32 radius = s0->collider.bounds_radius + s1->collider.bounds_radius;
 
   // ray starting at sphere0 last pos pointing toward sphere0 cur pos
   ray_t ray = RAY_T_INIT_ZERO();
@@ -168,26 +162,12 @@ collision_info_t phys_collision_check_sphere_v_sphere_swept(phys_obj_t* s0, phys
 
 collision_info_t phys_collision_check_aabb_v_aabb(phys_obj_t* b0, phys_obj_t* b1)
 {
-	// add position & offset to min & max of both colliders
+	// world aabb's of both colliders, from the cached bounds
 	vec3 a_min; vec3 a_max;
-	vec3_copy(b0->collider.box.aabb[0], a_min);
-	vec3_copy(b0->collider.box.aabb[1], a_max);
-  vec3_mul(a_min, b0->scl, a_min);
-  vec3_mul(a_max, b0->scl, a_max);
-	vec3_add(a_min, b0->pos, a_min);
-	vec3_add(a_max, b0->pos, a_max);
-	vec3_add(a_min, b0->collider.offset, a_min);
-	vec3_add(a_max, b0->collider.offset, a_max);
+  phys_obj_get_world_aabb(b0, a_min, a_max);
 
 	vec3 b_min; vec3 b_max;
-	vec3_copy(b1->collider.box.aabb[0], b_min);
-	vec3_copy(b1->collider.box.aabb[1], b_max);
-  vec3_mul(b_min, b1->scl, b_min);
-  vec3_mul(b_max, b1->scl, b_max);
-	vec3_add(b_min, b1->pos, b_min);
-	vec3_add(b_max, b1->pos, b_max);
-	vec3_add(b_min, b1->collider.offset, b_min);
-	vec3_add(b_max, b1->collider.offset, b_max);
+  phys_obj_get_world_aabb(b1, b_min, b_max);
 
 	bool collision = 
 		(a_min[0] <= b_max[0] && a_max[0] >= b_min[0]) &&
@@ -252,15 +232,14 @@ collision_info_t phys_collision_check_aabb_v_aabb_swept(phys_obj_t* b0, phys_obj
   // this way only one raycast is required
   // raycast is from b0 last pos toward b0 current pos
 	
-  collision_info_t info;
-  info.collision = false;
+  collision_info_t info = COLLISION_INFO_T_INIT();
 	
   vec3 pos0      = VEC3_INIT(0);  // current b0 pos
   vec3 last_pos0 = VEC3_INIT(0);  // b0 pos last frame
 	vec3 pos1      = VEC3_INIT(0);	// current b1 pos
-  vec3_add(b0->pos,      b0->collider.offset, pos0);
-  vec3_add(b0->last_pos, b0->collider.offset, last_pos0);
-	vec3_add(b1->pos,      b1->collider.offset, pos1);
+  vec3_add(PHYS_OBJ_POS(b0),      b0->collider.offset, pos0);
+  vec3_add(PHYS_OBJ_LAST_POS(b0), b0->collider.offset, last_pos0);
+	vec3_add(PHYS_OBJ_POS(b1),      b1->collider.offset, pos1);
 	
 
   // b0's and b1's aabb's combined , at b1 pos
@@ -272,8 +251,8 @@ collision_info_t phys_collision_check_aabb_v_aabb_swept(phys_obj_t* b0, phys_obj
   // add position & offset to min & max 
   vec3_mul(min, b1->scl, min);
   vec3_mul(max, b1->scl, max);
-	vec3_add(min, b1->pos, min);
-	vec3_add(max, b1->pos, max);
+	vec3_add(min, PHYS_OBJ_POS(b1), min);
+	vec3_add(max, PHYS_OBJ_POS(b1), max);
 	vec3_add(min, b1->collider.offset, min);
 	vec3_add(max, b1->collider.offset, max);
 
@@ -323,25 +302,17 @@ collision_info_t phys_collision_check_aabb_v_aabb_swept(phys_obj_t* b0, phys_obj
 //
 collision_info_t phys_collision_check_aabb_v_sphere(phys_obj_t* b, phys_obj_t* s, bool switch_obj_places)
 {
-  collision_info_t info;
-  info.collision = false;
+  collision_info_t info = COLLISION_INFO_T_INIT();
 
   vec3 b_pos, s_pos;
-  vec3_add(b->pos, b->collider.offset, b_pos);
-	vec3_add(s->pos, s->collider.offset, s_pos);
+  vec3_add(PHYS_OBJ_POS(b), b->collider.offset, b_pos);
+	vec3_add(PHYS_OBJ_POS(s), s->collider.offset, s_pos);
 
-  f32 radius = s->collider.sphere.radius * ((s->scl[0] + s->scl[1] + s->scl[2]) * 0.33f);
+  f32 radius = s->collider.bounds_radius;
 
-  // add position & offset to min & max of box collider
+  // world aabb of box collider
 	vec3 min; vec3 max;
-	vec3_copy(b->collider.box.aabb[0], min);
-	vec3_copy(b->collider.box.aabb[1], max);
-  vec3_mul(min, b->scl, min);
-  vec3_mul(max, b->scl, max);
-	vec3_add(min, b->pos, min);
-	vec3_add(max, b->pos, max);
-	vec3_add(min, b->collider.offset, min);
-	vec3_add(max, b->collider.offset, max);
+  phys_obj_get_world_aabb(b, min, max);
   
   // get box closest point to sphere center by clamping
   f32 x = MAX(min[0], MIN(s_pos[0], max[0]));
@@ -379,17 +350,16 @@ collision_info_t phys_collision_check_aabb_v_sphere_swept(phys_obj_t* b, phys_ob
   // this way only one raycast is required
   // raycast is from s last pos toward s current pos
 	
-  collision_info_t info;
-  info.collision = false;
+  collision_info_t info = COLLISION_INFO_T_INIT();
 	
   vec3 pos0      = VEC3_INIT(0);  // current s pos
   vec3 last_pos0 = VEC3_INIT(0);  // s pos last frame
 	vec3 pos1      = VEC3_INIT(0);	// current b pos
-  vec3_add(s->pos,      s->collider.offset, pos0);
-  vec3_add(s->last_pos, s->collider.offset, last_pos0);
-	vec3_add(b->pos,      b->collider.offset, pos1);
+  vec3_add(PHYS_OBJ_POS(s),      s->collider.offset, pos0);
+  vec3_add(PHYS_OBJ_LAST_POS(s), s->collider.offset, last_pos0);
+	vec3_add(PHYS_OBJ_POS(b),      b->collider.offset, pos1);
   
-  f32 radius = s->collider.sphere.radius * ((s->scl[0] + s->scl[1] + s->scl[2]) * 0.33f);
+  f32 radius = s->collider.bounds_radius;
 	
 
   // b's aabb scaled by s's radius s's pos
@@ -402,8 +372,8 @@ collision_info_t phys_collision_check_aabb_v_sphere_swept(phys_obj_t* b, phys_ob
   // add position & offset to min & max 
   vec3_mul(min, b->scl, min);
   vec3_mul(max, b->scl, max);
-	vec3_add(min, b->pos, min);
-	vec3_add(max, b->pos, max);
+	vec3_add(min, PHYS_OBJ_POS(b), min);
+	vec3_add(max, PHYS_OBJ_POS(b), max);
 	vec3_add(min, b->collider.offset, min);
 	vec3_add(max, b->collider.offset, max);
 
@@ -492,3 +462,208 @@ collision_info_t phys_collision_check_aabb_v_sphere_swept(phys_obj_t* b, phys_ob
   return info;
 }
 
+// ---- shape casts ----
+
+// slab test, same as phys_bvh_ray_v_aabb_dist() but also gives the axis the ray entered through
+//   axis: gets set to entry axis, -1 if pos is inside
+//   returns dist the ray enters the aabb, 0 if pos is inside, FLT_MAX if missed
+static f32 phys_collision_ray_v_aabb_axis(vec3 pos, vec3 dir, vec3 min, vec3 max, int* axis)
+{
+  f32 tmin = -FLT_MAX;
+  f32 tmax =  FLT_MAX;
+  *axis = -1;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (dir[i] == 0.0f)
+    {
+      if (pos[i] < min[i] || pos[i] > max[i]) { return FLT_MAX; }
+      continue;
+    }
+    f32 inv = 1.0f / dir[i];
+    f32 t1  = (min[i] - pos[i]) * inv;
+    f32 t2  = (max[i] - pos[i]) * inv;
+    f32 near = MIN(t1, t2);
+    if (near > tmin) { tmin = near; *axis = i; }
+    tmax = MIN(tmax, MAX(t1, t2));
+  }
+  if (tmax < 0.0f || tmin > tmax) { return FLT_MAX; }
+  if (tmin < 0.0f) { *axis = -1; return 0.0f; }
+  return tmin;
+}
+// dist the ray enters the sphere, pos has to be outside, FLT_MAX if missed
+static f32 phys_collision_ray_v_sphere_dist(vec3 pos, vec3 dir, vec3 center, f32 radius)
+{
+  vec3 m;
+  vec3_sub(pos, center, m);
+  f32 b = vec3_dot(m, dir);
+  f32 c = vec3_dot(m, m) - (radius * radius);
+  if (c > 0.0f && b > 0.0f) { return FLT_MAX; }
+  f32 discriminant = (b * b) - c;
+  if (discriminant < 0.0f) { return FLT_MAX; }
+  return MAX(-b - sqrtf(discriminant), 0.0f);
+}
+// dist the ray enters the infinite cylinder along axis through center, pos has to be outside, FLT_MAX if missed
+static f32 phys_collision_ray_v_cylinder_dist(vec3 pos, vec3 dir, vec3 center, f32 radius, int axis)
+{
+  // circle in the plane of the other two axes
+  int u = (axis + 1) % 3;
+  int v = (axis + 2) % 3;
+  f32 mu = pos[u] - center[u];
+  f32 mv = pos[v] - center[v];
+  f32 a  = (dir[u] * dir[u]) + (dir[v] * dir[v]);
+  if (a <= 0.0f) { return FLT_MAX; }  // parallel, only enters through the ends
+  f32 b  = (mu * dir[u]) + (mv * dir[v]);
+  f32 c  = (mu * mu) + (mv * mv) - (radius * radius);
+  if (c > 0.0f && b > 0.0f) { return FLT_MAX; }
+  f32 discriminant = (b * b) - (a * c);
+  if (discriminant < 0.0f) { return FLT_MAX; }
+  return MAX((-b - sqrtf(discriminant)) / a, 0.0f);
+}
+
+// contact point and normal from the shape's center at hit->dist and the closest point on the aabb to it
+static void phys_collision_cast_hit_aabb(ray_t* ray, vec3 min, vec3 max, ray_hit_t* hit)
+{
+  vec3 center;
+  vec3_mul_f(ray->dir, hit->dist, center);
+  vec3_add(center, ray->pos, center);
+  phys_util_closest_point_aabb(min, max, center, hit->hit_point);
+  vec3_sub(center, hit->hit_point, hit->normal);
+  f32 len = vec3_magnitude(hit->normal);
+  if (len > 0.0f) { vec3_mul_f(hit->normal, 1.0f / len, hit->normal); }
+  else            { vec3_mul_f(ray->dir, -1.0f, hit->normal); }
+}
+
+bool phys_collision_cast_sphere_v_sphere(ray_t* ray, f32 radius, vec3 pos, f32 s_rad, ray_hit_t* hit)
+{
+  hit->hit = false;
+  f32 r = radius + s_rad;
+  vec3 m;
+  vec3_sub(ray->pos, pos, m);
+  if (vec3_dot(m, m) <= r * r) { hit->dist = 0.0f; }
+  else
+  {
+    hit->dist = phys_collision_ray_v_sphere_dist(ray->pos, ray->dir, pos, r);
+    if (hit->dist == FLT_MAX) { return false; }
+  }
+
+  // normal from center to center, contact on the surface of the other sphere
+  vec3 center;
+  vec3_mul_f(ray->dir, hit->dist, center);
+  vec3_add(center, ray->pos, center);
+  vec3_sub(center, pos, hit->normal);
+  f32 len = vec3_magnitude(hit->normal);
+  if (hit->dist > 0.0f && len > 0.0f) { vec3_mul_f(hit->normal, 1.0f / len, hit->normal); }
+  else                                { vec3_mul_f(ray->dir, -1.0f, hit->normal); }
+  vec3_mul_f(hit->normal, s_rad, hit->hit_point);
+  vec3_add(hit->hit_point, pos, hit->hit_point);
+  hit->hit = true;
+  return true;
+}
+
+bool phys_collision_cast_sphere_v_aabb(ray_t* ray, f32 radius, vec3 min, vec3 max, ray_hit_t* hit)
+{
+  hit->hit = false;
+  vec3 closest;
+  phys_util_closest_point_aabb(min, max, ray->pos, closest);
+  if (vec3_distance(ray->pos, closest) <= radius)
+  {
+    hit->dist = 0.0f;
+    hit->hit  = true;
+    vec3_copy(closest, hit->hit_point);
+    vec3_mul_f(ray->dir, -1.0f, hit->normal);
+    return true;
+  }
+
+  // aabb grown by radius first, exact if entering through a face
+  vec3 ext_min = { min[0] - radius, min[1] - radius, min[2] - radius };
+  vec3 ext_max = { max[0] + radius, max[1] + radius, max[2] + radius };
+  int axis;
+  f32 dist = phys_collision_ray_v_aabb_axis(ray->pos, ray->dir, ext_min, ext_max, &axis);
+  if (dist == FLT_MAX) { return false; }
+
+  vec3 p;
+  vec3_mul_f(ray->dir, dist, p);
+  vec3_add(p, ray->pos, p);
+  int outside = 0;
+  for (int i = 0; i < 3; ++i) { outside += p[i] < min[i] || p[i] > max[i]; }
+
+  // entered at an edge or corner, closest of the three face slabs, 12 edges and 8 corners
+  if (outside > 1)
+  {
+    dist = FLT_MAX;
+    for (int a = 0; a < 3; ++a)
+    {
+      vec3 slab_min, slab_max;
+      vec3_copy(min, slab_min);
+      vec3_copy(max, slab_max);
+      slab_min[a] -= radius;
+      slab_max[a] += radius;
+      int slab_axis;
+      f32 d = phys_collision_ray_v_aabb_axis(ray->pos, ray->dir, slab_min, slab_max, &slab_axis);
+      dist = MIN(dist, d);
+    }
+    for (int c = 0; c < 8; ++c)
+    {
+      vec3 corner = { (c & 1) ? max[0] : min[0], (c & 2) ? max[1] : min[1], (c & 4) ? max[2] : min[2] };
+      dist = MIN(dist, phys_collision_ray_v_sphere_dist(ray->pos, ray->dir, corner, radius));
+      // edges along the axes, each edge once, from the min corner side
+      for (int a = 0; a < 3; ++a)
+      {
+        if (c & (1 << a)) { continue; }
+        f32 d = phys_collision_ray_v_cylinder_dist(ray->pos, ray->dir, corner, radius, a);
+        if (d == FLT_MAX) { continue; }
+        f32 along = ray->pos[a] + (ray->dir[a] * d);
+        if (along < min[a] || along > max[a]) { continue; }  // past the ends are the corners
+        dist = MIN(dist, d);
+      }
+    }
+    if (dist == FLT_MAX) { return false; }
+  }
+
+  hit->dist = dist;
+  hit->hit  = true;
+  phys_collision_cast_hit_aabb(ray, min, max, hit);
+  return true;
+}
+
+bool phys_collision_cast_aabb_v_aabb(ray_t* ray, vec3 ext, vec3 min, vec3 max, ray_hit_t* hit)
+{
+  hit->hit = false;
+  vec3 ext_min = { min[0] - ext[0], min[1] - ext[1], min[2] - ext[2] };
+  vec3 ext_max = { max[0] + ext[0], max[1] + ext[1], max[2] + ext[2] };
+  int axis;
+  hit->dist = phys_collision_ray_v_aabb_axis(ray->pos, ray->dir, ext_min, ext_max, &axis);
+  if (hit->dist == FLT_MAX) { return false; }
+
+  // face it entered through, closest point to the center would tilt the normal past edges
+  vec3 center;
+  vec3_mul_f(ray->dir, hit->dist, center);
+  vec3_add(center, ray->pos, center);
+  phys_util_closest_point_aabb(min, max, center, hit->hit_point);
+  if (axis < 0) { vec3_mul_f(ray->dir, -1.0f, hit->normal); }
+  else
+  {
+    vec3 normal = { 0.0f, 0.0f, 0.0f };
+    normal[axis] = ray->dir[axis] > 0.0f ? -1.0f : 1.0f;
+    vec3_copy(normal, hit->normal);
+  }
+  hit->hit = true;
+  return true;
+}
+
+bool phys_collision_cast_aabb_v_sphere(ray_t* ray, vec3 ext, vec3 pos, f32 s_rad, ray_hit_t* hit)
+{
+  // aabb touches sphere when its center is within s_rad of an aabb around pos its size
+  vec3 min = { pos[0] - ext[0], pos[1] - ext[1], pos[2] - ext[2] };
+  vec3 max = { pos[0] + ext[0], pos[1] + ext[1], pos[2] + ext[2] };
+  if (!phys_collision_cast_sphere_v_aabb(ray, s_rad, min, max, hit)) { return false; }
+
+  // contact on the surface of the sphere, normal from its center
+  if (hit->dist > 0.0f)
+  {
+    vec3_mul_f(hit->normal, s_rad, hit->hit_point);
+    vec3_add(hit->hit_point, pos, hit->hit_point);
+  }
+  else { vec3_copy(pos, hit->hit_point); }
+  return true;
+}
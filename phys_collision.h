@@ -6,6 +6,7 @@
 #include "math/math_inc.h"
 #include "math/math_vec3.h"
 #include "phys/phys_types.h" 
+#include "phys/phys_bodies.h"
 #include "phys/phys_debug_draw.h" 
 #include <float.h>
 
@@ -38,21 +39,36 @@ collision_info_t phys_collision_check_aabb_v_aabb_swept(phys_obj_t* b0, phys_obj
 collision_info_t phys_collision_check_aabb_v_sphere(phys_obj_t* b, phys_obj_t* s, bool switch_obj_places);
 collision_info_t phys_collision_check_aabb_v_sphere_swept(phys_obj_t* b, phys_obj_t* s, bool switch_obj_places);
 
+// --- shape casts ---
+// shape moves along ray, ray->pos is its center at the start, ray->dir normalized, ray->len gets ignored
+// hit->dist:      dist along ray until it touches, 0 if it starts overlapping
+// hit->hit_point: contact point on the other shape
+// hit->normal:    surface normal of the other shape at hit_point, -ray->dir if it starts overlapping
+
+// @DOC: sweep sphere against sphere, ray against sphere with both radii
+//       radius:     radius of the swept sphere
+//       pos, s_rad: center and radius of the other sphere
+bool phys_collision_cast_sphere_v_sphere(ray_t* ray, f32 radius, vec3 pos, f32 s_rad, ray_hit_t* hit);
+// @DOC: sweep sphere against aabb, ray against the aabb grown by radius, with rounded edges and corners
+//       radius:   radius of the swept sphere
+//       min, max: world aabb of the other shape
+bool phys_collision_cast_sphere_v_aabb(ray_t* ray, f32 radius, vec3 min, vec3 max, ray_hit_t* hit);
+// @DOC: sweep aabb against aabb, ray against the aabb grown by ext
+//       ext:      half extents of the swept aabb
+//       min, max: world aabb of the other shape
+bool phys_collision_cast_aabb_v_aabb(ray_t* ray, vec3 ext, vec3 min, vec3 max, ray_hit_t* hit);
+// @DOC: sweep aabb against sphere, same as a sphere against an aabb the size of the swept one
+//       ext:        half extents of the swept aabb
+//       pos, s_rad: center and radius of the other sphere
+bool phys_collision_cast_aabb_v_sphere(ray_t* ray, vec3 ext, vec3 pos, f32 s_rad, ray_hit_t* hit);
+
 
 // --- inline funcs ---
 
 // @TODO: make phys_util.h and put there
 INLINE void phys_util_obj_get_aabb(phys_obj_t* box, vec3 min, vec3 max)
 {
-  // add position & offset to min & max of both colliders
-	vec3_copy(box->collider.box.aabb[0], min);
-	vec3_copy(box->collider.box.aabb[1], max);
-  vec3_mul(min, box->scl, min);
-  vec3_mul(max, box->scl, max);
-	vec3_add(min, box->pos, min);
-	vec3_add(max, box->pos, max);
-	vec3_add(min, box->collider.offset, min);
-	vec3_add(max, box->collider.offset, max);
+  phys_obj_get_world_aabb(box, min, max);
 }
 INLINE void phys_util_closest_point_aabb(vec3 min, vec3 max, vec3 p, vec3 out)
 {
@@ -113,9 +129,8 @@ INLINE bool phys_collision_check_ray_v_sphere_obj(ray_t* ray, phys_obj_t* sphere
 {
   if (!PHYS_OBJ_HAS_COLLIDER(sphere) || sphere->collider.type != PHYS_COLLIDER_SPHERE) { return false; }
   vec3 sphere_pos = VEC3_INIT(0);
-  vec3_add(sphere->pos, sphere->collider.offset, sphere_pos);
-  f32 radius = sphere->collider.sphere.radius * ( (sphere->scl[0] + sphere->scl[1] + sphere->scl[2]) * 0.33f);
-  return phys_collision_check_ray_v_sphere(ray, sphere_pos, radius, hit); 
+  vec3_add(PHYS_OBJ_POS(sphere), sphere->collider.offset, sphere_pos);
+  return phys_collision_check_ray_v_sphere(ray, sphere_pos, sphere->collider.bounds_radius, hit); 
 }
  
 
@@ -168,19 +183,11 @@ INLINE bool phys_collision_check_ray_v_aabb_obj(ray_t* ray, phys_obj_t* box, ray
 {
   if (!PHYS_OBJ_HAS_COLLIDER(box) || box->collider.type != PHYS_COLLIDER_BOX) { return false; }
 	
-  // add position & offset to min & max of both colliders
 	vec3 min, max;
-	vec3_copy(box->collider.box.aabb[0], min);
-	vec3_copy(box->collider.box.aabb[1], max);
-  vec3_mul(min, box->scl, min);
-  vec3_mul(max, box->scl, max);
-	vec3_add(min, box->pos, min);
-	vec3_add(max, box->pos, max);
-	vec3_add(min, box->collider.offset, min);
-	vec3_add(max, box->collider.offset, max);
+  phys_obj_get_world_aabb(box, min, max);
  
   bool rtn = phys_collision_check_ray_v_aabb(ray, min, max, hit);
-  vec3_sub(hit->hit_point, box->pos, hit->normal);
+  vec3_sub(hit->hit_point, PHYS_OBJ_POS(box), hit->normal);
   vec3_normalize(hit->normal, hit->normal);
   return rtn;
 }
@@ -391,7 +398,7 @@ INLINE bool phys_collision_check_aabb_v_triangle_obj(phys_obj_t* box, vec3 v0, v
 {
   // add to pos not min/max bc. aabb_v_triangle() uses center/pos and extends
   vec3 pos; 
-	vec3_add(box->pos, box->collider.offset, pos);
+	vec3_add(PHYS_OBJ_POS(box), box->collider.offset, pos);
   // debug_draw_sphere(pos, 0.5f, RGB_F(0, 1, 0));
   vec3 max;
   vec3_copy(box->collider.box.aabb[1], max);
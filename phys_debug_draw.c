@@ -8,10 +8,10 @@ void phys_debug_draw_velocity_func(phys_obj_t* obj)
   if (!PHYS_OBJ_HAS_RIGIDBODY(obj)) { return; }
 
   vec3 v_scaled, v_pos;
-	vec3_copy(obj->rb.velocity, v_scaled);
+	vec3_copy(PHYS_OBJ_VELOCITY(obj), v_scaled);
 	vec3_mul_f(v_scaled, 0.2f, v_scaled);
-	vec3_add(obj->pos, v_scaled, v_pos);
-  debug_draw_line(obj->pos, v_pos, PHYS_DEBUG_VELOCITY_COLOR); 
+	vec3_add(PHYS_OBJ_POS(obj), v_scaled, v_pos);
+  debug_draw_line(PHYS_OBJ_POS(obj), v_pos, PHYS_DEBUG_VELOCITY_COLOR); 
 }
 
 void phys_debug_draw_collider_func(phys_obj_t* obj, f32* color)
@@ -32,11 +32,11 @@ void phys_debug_draw_sphere_collider_func(phys_obj_t* obj, f32* color)
 {
 	if (!PHYS_OBJ_HAS_COLLIDER(obj)) { return; }
   
-  f32 radius = obj->collider.sphere.radius * ((obj->scl[0] + obj->scl[1] + obj->scl[2]) * 0.33f);
-  // debug_draw_circle_register(VEC3_XYZ(1, 1, 0), obj->pos, radius, color);
-  // debug_draw_circle_register(VEC3_XYZ(1, 0, 1), obj->pos, radius, color);
-  // debug_draw_circle_register(VEC3_XYZ(0, 1, 1), obj->pos, radius, color);
-  debug_draw_circle_sphere(obj->pos, radius, color);
+  f32 radius = obj->collider.bounds_radius;
+  // debug_draw_circle_register(VEC3_XYZ(1, 1, 0), PHYS_OBJ_POS(obj), radius, color);
+  // debug_draw_circle_register(VEC3_XYZ(1, 0, 1), PHYS_OBJ_POS(obj), radius, color);
+  // debug_draw_circle_register(VEC3_XYZ(0, 1, 1), PHYS_OBJ_POS(obj), radius, color);
+  debug_draw_circle_sphere(PHYS_OBJ_POS(obj), radius, color);
 }
 
 void phys_debug_draw_aabb_func(vec3 min, vec3 max, f32* color)
@@ -66,18 +66,8 @@ void phys_debug_draw_box_collider_func(phys_obj_t* obj, f32* color)
 {
 	if (!PHYS_OBJ_HAS_COLLIDER(obj)) { return; }
   
-  vec3* aabb = obj->collider.box.aabb;
-  vec3  min, max;
-  vec3_copy(aabb[0], min);
-  vec3_copy(aabb[1], max);
-  vec3_mul(obj->scl, min, min);
-  vec3_mul(obj->scl, max, max);
- 	vec3_add(min, obj->collider.offset, min);
-	vec3_add(max, obj->collider.offset, max); 
-  
-  vec3_add(obj->pos, min, min);
-  vec3_add(obj->pos, max, max);
-  
+  vec3 min, max;
+  phys_obj_get_world_aabb(obj, min, max);
 
   phys_debug_draw_aabb_func(min, max, color);
 }
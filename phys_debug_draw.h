@@ -10,6 +10,7 @@ extern "C" {
 #ifdef PHYS_DEBUG
 
 #include "phys/phys_types.h"
+#include "phys/phys_bodies.h"
 
 // @DOC: color given to velocity debug display
 #define PHYS_DEBUG_VELOCITY_COLOR          RGB_F(1, 0, 1)
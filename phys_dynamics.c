@@ -1,5 +1,6 @@
 #include "phys/phys_dynamics.h"
 #include "phys/phys_debug_draw.h"
+#include "phys/phys_simd.h"
 
 // #include "global/global.h"
 #include "phys/phys_types.h"
@@ -9,6 +10,14 @@
 // const vec3 gravity = { 0.0f, -18.0f, 0.0f };
 const vec3 gravity = { 0.0f, -30.0f, 0.0f };
 
+// bodies per batch in phys_dynamics_simulate_bodies(), multiple of PHYS_SIMD_WIDTH
+#define PHYS_DYNAMICS_BATCH  64
+// drag values phys_dynamics_simulate_bodies() keeps powf() results for
+#define PHYS_DYNAMICS_POW_CACHE  4
+
+// see phys_dynamics_set_strict()
+bool phys_dynamics_strict = true;
+
 // ---- dynamics ----
 
 void phys_dynamics_simulate(phys_obj_t* obj, f32 dt)
@@ -17,7 +26,7 @@ void phys_dynamics_simulate(phys_obj_t* obj, f32 dt)
   
   // ERR_CHECK(obj->rb.mass > 1.0f, "mass: %f, id: %d\n", obj->rb.mass, obj->entity_idx);
   // PF("id: %d, mass: %f\n", obj->entity_idx, obj->rb.mass);
-  // PF("id: %d, ", obj->entity_idx); P_VEC3(obj->rb.velocity);
+  // PF("id: %d, ", obj->entity_idx); P_VEC3(PHYS_OBJ_VELOCITY(obj));
   // P_COLLIDER_TYPE_T(obj->collider.type);
   // P_COLLIDER_T(obj->collider);
   // P_RIGIDBODY_T(obj->rb);
@@ -30,49 +39,146 @@ void phys_dynamics_simulate(phys_obj_t* obj, f32 dt)
 	//    vec3 mass = { obj->rb.mass, obj->rb.mass , obj->rb.mass };
 	//    vec3 mg;
 	//    vec3_mul(mass, (f32*)gravity, mg);
-	//    vec3_add(obj->rb.force, mg, obj->rb.force);
+	//    vec3_add(PHYS_OBJ_FORCE(obj), mg, PHYS_OBJ_FORCE(obj));
 
 	//    // add (force / mass) * delta_t to velocity
 	//    vec3 fdm;
-	//    vec3_div(obj->rb.force, mass, fdm);
+	//    vec3_div(PHYS_OBJ_FORCE(obj), mass, fdm);
 	//    vec3 delta_t = { dt, dt, dt };
 	//    vec3_mul(fdm, delta_t, fdm);
-	//    vec3_add(obj->rb.velocity, fdm, obj->rb.velocity);
+	//    vec3_add(PHYS_OBJ_VELOCITY(obj), fdm, PHYS_OBJ_VELOCITY(obj));
 
 	//    // position += velocity * delta_t
 	//    vec3 v;
-	//    vec3_mul(obj->rb.velocity, delta_t, v);
+	//    vec3_mul(PHYS_OBJ_VELOCITY(obj), delta_t, v);
 
   //    // vel *= pow(drag, dt)
-	//    vec3_add(obj->pos, v, obj->pos);
+	//    vec3_add(PHYS_OBJ_POS(obj), v, PHYS_OBJ_POS(obj));
 
 	//    
   //    // reset force to (0, 0, 0)
-	//    vec3_copy(VEC3(0), obj->rb.force);
+	//    vec3_copy(VEC3(0), PHYS_OBJ_FORCE(obj));
  
 
 
 	// acceleration accumulator
-	// vec3_add((f32*)gravity, obj->rb.force, obj->rb.force);
-	obj->rb.force[1] += gravity[1];
-	vec3_mul_f(obj->rb.force, dt, obj->rb.force);
+	// vec3_add((f32*)gravity, PHYS_OBJ_FORCE(obj), PHYS_OBJ_FORCE(obj));
+	PHYS_OBJ_FORCE(obj)[1] += gravity[1];
+	vec3_mul_f(PHYS_OBJ_FORCE(obj), dt, PHYS_OBJ_FORCE(obj));
 
 	// vel += force
-	vec3_add(obj->rb.velocity, obj->rb.force, obj->rb.velocity);
+	vec3_add(PHYS_OBJ_VELOCITY(obj), PHYS_OBJ_FORCE(obj), PHYS_OBJ_VELOCITY(obj));
 
 	// vel *= pow(drag, dt), increase friction when colliding
   f32 drag = (PHYS_OBJ_HAS_COLLIDER(obj) && obj->collider.is_colliding) ? obj->rb.drag * obj->rb.friction : obj->rb.drag;
   f32 dt_drag = powf(drag, dt);
   // f32 dt_drag = drag * dt;
-	vec3_mul_f(obj->rb.velocity, dt_drag, obj->rb.velocity);
+	vec3_mul_f(PHYS_OBJ_VELOCITY(obj), dt_drag, PHYS_OBJ_VELOCITY(obj));
 
 	// pos += vel * dt 
 	vec3 v_dt;
-	vec3_mul_f(obj->rb.velocity, dt, v_dt);
-	vec3_copy(obj->pos, obj->last_pos); // set last frames pos
-	vec3_add(obj->pos, v_dt, obj->pos);
+	vec3_mul_f(PHYS_OBJ_VELOCITY(obj), dt, v_dt);
+	vec3_copy(PHYS_OBJ_POS(obj), PHYS_OBJ_LAST_POS(obj)); // set last frames pos
+	vec3_add(PHYS_OBJ_POS(obj), v_dt, PHYS_OBJ_POS(obj));
 
 	// reset accumulator
-	vec3_copy(VEC3(0), obj->rb.force);
+	vec3_copy(VEC3(0), PHYS_OBJ_FORCE(obj));
+
+}
+
+void phys_dynamics_set_strict(bool strict)
+{
+  phys_dynamics_strict = strict;
+}
+
+// PHYS_SIMD_WIDTH floats of the packed vec3 arrs, same steps as phys_dynamics_simulate()
+// gravity is already in force, the lanes dont know which axis they are on
+// strict does mul and add separately, like the scalar version, fma rounds once instead of twice
+#define PHYS_DYNAMICS_LANES(i, j, strict)                                               \
+{                                                                                       \
+  phys_maskx_t sleeping = PHYS_MASKX_FROM_U8(sleeping3 + (j));                          \
+  phys_f32x_t  dd = PHYS_F32X_LOAD(dt_drag3 + (j));                                     \
+  phys_f32x_t  p  = PHYS_F32X_LOAD(pos + (i));                                          \
+  phys_f32x_t  lp = PHYS_F32X_LOAD(last_pos + (i));                                     \
+  phys_f32x_t  v  = PHYS_F32X_LOAD(velocity + (i));                                     \
+  phys_f32x_t  f  = PHYS_F32X_LOAD(force + (i));                                        \
+  phys_f32x_t  nv, np;                                                                  \
+  if (strict)                                                                           \
+  {                                                                                     \
+    nv = PHYS_F32X_ADD(v, PHYS_F32X_MUL(f, dt_x));                                      \
+    nv = PHYS_F32X_MUL(nv, dd);                                                         \
+    np = PHYS_F32X_ADD(p, PHYS_F32X_MUL(nv, dt_x));                                     \
+  }                                                                                     \
+  else                                                                                  \
+  {                                                                                     \
+    nv = PHYS_F32X_MUL(PHYS_F32X_FMADD(f, dt_x, v), dd);                                \
+    np = PHYS_F32X_FMADD(nv, dt_x, p);                                                  \
+  }                                                                                     \
+  /* sleeping bodies keep their state */                                                \
+  PHYS_F32X_STORE(velocity + (i), PHYS_F32X_SELECT(sleeping, v, nv));                   \
+  PHYS_F32X_STORE(last_pos + (i), PHYS_F32X_SELECT(sleeping, lp, p));                   \
+  PHYS_F32X_STORE(pos + (i),      PHYS_F32X_SELECT(sleeping, p, np));                   \
+  PHYS_F32X_STORE(force + (i),    PHYS_F32X_SELECT(sleeping, f, zero));                 \
+}
+
+void phys_dynamics_simulate_bodies(phys_bodies_t* b, u32 start, u32 end, f32 dt)
+{
+  bool strict = phys_dynamics_strict;
+  phys_f32x_t dt_x = PHYS_F32X_SET1(dt);
+  phys_f32x_t zero = PHYS_F32X_SET1(0.0f);
+
+  // vec3 arrs as one f32 arr each, x0 y0 z0 x1 y1 z1 ...
+  f32* pos      = (f32*)b->pos;
+  f32* last_pos = (f32*)b->last_pos;
+  f32* velocity = (f32*)b->velocity;
+  f32* force    = (f32*)b->force;
+
+  // powf() per body, same drag and dt give the same result
+  // most bodies share a few drag values, colliding or not, so cache the last ones
+  // dt_drag3 and sleeping3 have one entry per float, so the lanes can run across bodies
+  f32 dt_drag3[PHYS_DYNAMICS_BATCH * 3];
+  u8  sleeping3[PHYS_DYNAMICS_BATCH * 3];
+  f32 cache_drag[PHYS_DYNAMICS_POW_CACHE];
+  f32 cache_dt_drag[PHYS_DYNAMICS_POW_CACHE];
+  u32 cache_len  = 0;
+  u32 cache_next = 0;
+  for (u32 batch = start; batch < end; batch += PHYS_DYNAMICS_BATCH)
+  {
+    u32 batch_end = MIN(batch + PHYS_DYNAMICS_BATCH, end);
+    for (u32 i = batch; i < batch_end; ++i)
+    {
+      f32 drag = b->drag[i];
+      u32 c = 0;
+      while (c < cache_len && cache_drag[c] != drag) { c++; }
+      if (c >= cache_len)
+      {
+        c = cache_next;
+        cache_next = (cache_next +1) % PHYS_DYNAMICS_POW_CACHE;
+        cache_len  = MIN(cache_len +1, PHYS_DYNAMICS_POW_CACHE);
+        cache_drag[c]    = drag;
+        cache_dt_drag[c] = powf(drag, dt);
+      }
+      u32 j = (i - batch) * 3;
+      dt_drag3[j +0] = dt_drag3[j +1] = dt_drag3[j +2] = cache_dt_drag[c];
+      sleeping3[j +0] = sleeping3[j +1] = sleeping3[j +2] = b->is_sleeping[i];
+
+      // gravity only on y, adding 0 would turn -0 into +0
+      if (!b->is_sleeping[i]) { b->force[i][1] += gravity[1]; }
+    }
 
+    u32 i    = batch * 3;
+    u32 end3 = batch_end * 3;
+    for (; i + PHYS_SIMD_WIDTH <= end3; i += PHYS_SIMD_WIDTH)
+    { PHYS_DYNAMICS_LANES(i, i - batch * 3, strict); }
+    // rest, one at a time
+    for (; i < end3; ++i)
+    {
+      u32 j = i - batch * 3;
+      if (sleeping3[j]) { continue; }
+      velocity[i] = (velocity[i] + force[i] * dt) * dt_drag3[j];
+      last_pos[i] = pos[i];
+      pos[i]      = pos[i] + velocity[i] * dt;
+      force[i]    = 0.0f;
+    }
+  }
 }
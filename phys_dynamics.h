@@ -2,6 +2,7 @@
 #define PHYS_PHYS_DYNAMICS_H
 
 #include "phys/phys_world.h" // has phys_types.h, global.h, object_data.h
+#include "phys/phys_bodies.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -12,6 +13,17 @@ extern "C" {
 //       obj: object to be simulated
 //       dt:  delta time, time since last frame
 void phys_dynamics_simulate(phys_obj_t* phys, f32 dt);
+// @DOC: same as phys_dynamics_simulate(), for a range of bodies, skips sleeping ones
+//       PHYS_SIMD_WIDTH bodies at a time, see phys_simd.h
+//       b:          hot state of the objs, drag and is_sleeping have to be set, see phys_bodies_t
+//       start, end: range of rigidbodies, [start, end), same idx as in phys_objs
+//       dt:         delta time, time since last frame
+void phys_dynamics_simulate_bodies(phys_bodies_t* b, u32 start, u32 end, f32 dt);
+// @DOC: strict makes phys_dynamics_simulate_bodies() give the same bits as phys_dynamics_simulate()
+//       on every simd path, otherwise it can use fma, which is faster but rounds differently
+//       the scalar versions themselves need -ffp-contract=off to not get fma'd by the compiler
+//       strict: true by default
+void phys_dynamics_set_strict(bool strict);
 
 #ifdef __cplusplus
 } // extern c
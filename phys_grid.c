@@ -0,0 +1,140 @@
+#include "phys/phys_grid.h"
+#include "phys/phys_arena.h"
+
+#include "stb/stb_ds.h"
+
+
+static u32 phys_grid_hash(int ix, int iy, int iz)
+{
+  return ((u32)ix * 73856093u) ^ ((u32)iy * 19349663u) ^ ((u32)iz * 83492791u);
+}
+static int phys_grid_cell(f32 v, f32 cell_size)
+{
+  // far away or nan aabb's get clamped, casting them to int is undefined
+  // the clamped range still fits x1 - x0 + 1 in an int
+  f32 c = floorf(v / cell_size);
+  if (!(c > -PHYS_GRID_CELL_MAX)) { return -(int)PHYS_GRID_CELL_MAX; }
+  if (c > PHYS_GRID_CELL_MAX)     { return  (int)PHYS_GRID_CELL_MAX; }
+  return (int)c;
+}
+
+void phys_grid_clear(phys_grid_t* grid)
+{
+  ARRFREE(grid->items);
+  grid->items_len = 0;
+  ARRFREE(grid->entries);
+  grid->entries_len = 0;
+  ARRFREE(grid->entries_sorted);
+  ARRFREE(grid->bucket_start);
+  ARRFREE(grid->bucket_fill);
+  grid->buckets_len = 0;
+}
+
+void phys_grid_begin(phys_grid_t* grid, f32 cell_size)
+{
+  ASSERT(cell_size > 0.0f);
+  grid->cell_size = cell_size;
+  arrsetlen(grid->items, 0);
+  grid->items_len = 0;
+  arrsetlen(grid->entries, 0);
+  grid->entries_len = 0;
+}
+
+bool phys_grid_add(phys_grid_t* grid, vec3 min, vec3 max, int user)
+{
+  int x0 = phys_grid_cell(min[0], grid->cell_size);
+  int y0 = phys_grid_cell(min[1], grid->cell_size);
+  int z0 = phys_grid_cell(min[2], grid->cell_size);
+  int x1 = phys_grid_cell(max[0], grid->cell_size);
+  int y1 = phys_grid_cell(max[1], grid->cell_size);
+  int z1 = phys_grid_cell(max[2], grid->cell_size);
+
+  // f32 so huge aabb's cant overflow
+  f32 cells = (f32)(x1 - x0 + 1) * (f32)(y1 - y0 + 1) * (f32)(z1 - z0 + 1);
+  if (cells > (f32)PHYS_GRID_MAX_CELLS_PER_ITEM) { return false; }
+
+  phys_grid_item_t item;
+  item.user = user;
+  vec3_copy(min, item.min);
+  vec3_copy(max, item.max);
+  PHYS_ARRPUT(grid->items, item);
+  u32 item_idx = grid->items_len++;
+
+  for (int x = x0; x <= x1; ++x)
+  {
+    for (int y = y0; y <= y1; ++y)
+    {
+      for (int z = z0; z <= z1; ++z)
+      {
+        phys_grid_entry_t e = { .ix = x, .iy = y, .iz = z, .item = item_idx, .bucket = 0 };
+        PHYS_ARRPUT(grid->entries, e);
+        grid->entries_len++;
+      }
+    }
+  }
+  return true;
+}
+
+void phys_grid_find_pairs(phys_grid_t* grid, phys_grid_pair_callback* callback, void* data)
+{
+  if (grid->entries_len <= 1) { return; }
+
+  // ---- sort entries into buckets ----
+  // counting sort, buckets at least twice the entries to keep collisions low
+  u32 buckets_len = 64;
+  while (buckets_len < grid->entries_len * 2) { buckets_len *= 2; }
+  grid->buckets_len = buckets_len;
+  PHYS_ARRSETLEN(grid->bucket_start, buckets_len +1);
+  PHYS_ARRSETLEN(grid->bucket_fill,  buckets_len);
+  PHYS_ARRSETLEN(grid->entries_sorted, grid->entries_len);
+  memset(grid->bucket_start, 0, sizeof(u32) * (buckets_len +1));
+
+  for (u32 i = 0; i < grid->entries_len; ++i)
+  {
+    phys_grid_entry_t* e = &grid->entries[i];
+    e->bucket = phys_grid_hash(e->ix, e->iy, e->iz) & (buckets_len -1);
+    grid->bucket_start[e->bucket +1]++;
+  }
+  for (u32 b = 0; b < buckets_len; ++b)
+  {
+    grid->bucket_start[b +1] += grid->bucket_start[b];
+    grid->bucket_fill[b]      = grid->bucket_start[b];
+  }
+  for (u32 i = 0; i < grid->entries_len; ++i)
+  {
+    phys_grid_entry_t* e = &grid->entries[i];
+    grid->entries_sorted[grid->bucket_fill[e->bucket]++] = *e;
+  }
+
+  // ---- pairs per cell ----
+  // items covering multiple cells share more than one cell
+  // so a pair only gets reported in the cell containing the min corner of both aabb's overlap
+  f32 cell_size = grid->cell_size;
+  for (u32 b = 0; b < buckets_len; ++b)
+  {
+    u32 start = grid->bucket_start[b];
+    u32 end   = grid->bucket_start[b +1];
+    for (u32 i = start; i < end; ++i)
+    {
+      phys_grid_entry_t* e0 = &grid->entries_sorted[i];
+      phys_grid_item_t*  i0 = &grid->items[e0->item];
+      for (u32 j = i +1; j < end; ++j)
+      {
+        phys_grid_entry_t* e1 = &grid->entries_sorted[j];
+        // different cell, same bucket
+        if (e0->ix != e1->ix || e0->iy != e1->iy || e0->iz != e1->iz) { continue; }
+
+        phys_grid_item_t* i1 = &grid->items[e1->item];
+        if (i0->min[0] > i1->max[0] || i0->max[0] < i1->min[0] ||
+            i0->min[1] > i1->max[1] || i0->max[1] < i1->min[1] ||
+            i0->min[2] > i1->max[2] || i0->max[2] < i1->min[2]) { continue; }
+
+        if (phys_grid_cell(MAX(i0->min[0], i1->min[0]), cell_size) != e0->ix ||
+            phys_grid_cell(MAX(i0->min[1], i1->min[1]), cell_size) != e0->iy ||
+            phys_grid_cell(MAX(i0->min[2], i1->min[2]), cell_size) != e0->iz) { continue; }
+
+        callback(i0->user, i1->user, data);
+      }
+    }
+  }
+}
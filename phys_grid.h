@@ -0,0 +1,90 @@
+#ifndef PHYS_PHYS_GRID_H
+#define PHYS_PHYS_GRID_H
+
+#include "global/global.h"
+#include "phys/phys_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: items covering more cells than this dont get added, see phys_grid_add()
+#define PHYS_GRID_MAX_CELLS_PER_ITEM  64
+// @DOC: cell coords get clamped to [-PHYS_GRID_CELL_MAX, PHYS_GRID_CELL_MAX]
+#define PHYS_GRID_CELL_MAX  1000000000.0f
+
+// @DOC: aabb added to phys_grid_t
+typedef struct
+{
+  int  user;  // user data, i.e. proxy idx
+  vec3 min;
+  vec3 max;
+
+}phys_grid_item_t;
+
+// @DOC: one cell covered by a phys_grid_item_t
+typedef struct
+{
+  int ix, iy, iz; // cell coordinates
+  u32 item;       // idx into phys_grid_t.items
+  u32 bucket;     // hashed cell coordinates
+
+}phys_grid_entry_t;
+
+// @DOC: uniform grid, cells get hashed into buckets so the grid has no bounds
+//       gets rebuilt every frame, all arrays get reused so only grows memory
+typedef struct
+{
+  f32 cell_size;
+
+  phys_grid_item_t* items;
+  u32 items_len;
+
+  phys_grid_entry_t* entries;       // every cell of every item
+  u32 entries_len;
+  phys_grid_entry_t* entries_sorted;// entries sorted by bucket
+
+  u32* bucket_start;  // idx of first entry in entries_sorted per bucket, [buckets_len] is entries_len
+  u32* bucket_fill;   // used while sorting
+  u32  buckets_len;   // always power of 2
+
+}phys_grid_t;
+#define PHYS_GRID_T_INIT()    \
+{                             \
+  .cell_size      = 4.0f,     \
+  .items          = NULL,     \
+  .items_len      = 0,        \
+  .entries        = NULL,     \
+  .entries_len    = 0,        \
+  .entries_sorted = NULL,     \
+  .bucket_start   = NULL,     \
+  .bucket_fill    = NULL,     \
+  .buckets_len    = 0,        \
+}
+
+// @DOC: func type called for every pair found by phys_grid_find_pairs()
+//       user0, user1: user data of both items
+//       data:         data passed to phys_grid_find_pairs()
+typedef void (phys_grid_pair_callback)(int user0, int user1, void* data);
+
+// @DOC: free all memory of grid
+void phys_grid_clear(phys_grid_t* grid);
+
+// @DOC: remove all items, keeps memory
+//       cell_size: size of a cell, should be about the size of the items
+void phys_grid_begin(phys_grid_t* grid, f32 cell_size);
+// @DOC: add item to grid
+//       min, max: aabb of item
+//       user:     user data, i.e. proxy idx
+//       returns false and doesnt add item if it covers more than PHYS_GRID_MAX_CELLS_PER_ITEM cells
+bool phys_grid_add(phys_grid_t* grid, vec3 min, vec3 max, int user);
+// @DOC: call callback once for every pair of items whichs aabb's overlap
+//       callback: gets called with user data of both items
+//       data:     gets passed to callback
+void phys_grid_find_pairs(phys_grid_t* grid, phys_grid_pair_callback* callback, void* data);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+#include "phys/phys_hash.h"
+#include "phys/phys_arena.h"
+
+#include "stb/stb_ds.h"
+
+
+#define PHYS_HASH_MIN_CAP  16
+
+// fibonacci hashing, keys made of close idx's end up spread out
+static u32 phys_hash_slot(phys_hash_t* h, u64 key)
+{
+  return (u32)((key * 11400714819323198485ull) >> h->shift);
+}
+
+void phys_hash_clear(phys_hash_t* h)
+{
+  ARRFREE(h->keys);
+  ARRFREE(h->values);
+  h->cap   = 0;
+  h->len   = 0;
+  h->shift = 64;
+}
+
+void phys_hash_reserve(phys_hash_t* h, u32 len)
+{
+  // keep it at most half full
+  u32 cap   = PHYS_HASH_MIN_CAP;
+  u32 shift = 64 - 4;
+  while (cap < len * 2) { cap *= 2; shift--; }
+  if (cap <= h->cap) { return; }
+
+  u64* old_keys   = h->keys;
+  u32* old_values = h->values;
+  u32  old_cap    = h->cap;
+  h->keys   = NULL;
+  h->values = NULL;
+  PHYS_ARRSETLEN(h->keys,   cap);
+  PHYS_ARRSETLEN(h->values, cap);
+  for (u32 i = 0; i < cap; ++i) { h->keys[i] = PHYS_HASH_EMPTY; }
+  h->cap   = cap;
+  h->shift = shift;
+
+  // rehash, no duplicates so no need to check for the key
+  for (u32 i = 0; i < old_cap; ++i)
+  {
+    if (old_keys[i] == PHYS_HASH_EMPTY) { continue; }
+    u32 s = phys_hash_slot(h, old_keys[i]);
+    while (h->keys[s] != PHYS_HASH_EMPTY) { s = (s + 1) & (cap -1); }
+    h->keys[s]   = old_keys[i];
+    h->values[s] = old_values[i];
+  }
+  ARRFREE(old_keys);
+  ARRFREE(old_values);
+}
+
+u32* phys_hash_get(phys_hash_t* h, u64 key)
+{
+  if (h->len == 0) { return NULL; }
+  for (u32 s = phys_hash_slot(h, key); h->keys[s] != PHYS_HASH_EMPTY; s = (s + 1) & (h->cap -1))
+  {
+    if (h->keys[s] == key) { return &h->values[s]; }
+  }
+  return NULL;
+}
+
+void phys_hash_put(phys_hash_t* h, u64 key, u32 value)
+{
+  ASSERT(key != PHYS_HASH_EMPTY);
+  phys_hash_reserve(h, h->len + 1);
+
+  u32 s = phys_hash_slot(h, key);
+  while (h->keys[s] != PHYS_HASH_EMPTY)
+  {
+    ASSERT(h->keys[s] != key);
+    s = (s + 1) & (h->cap -1);
+  }
+  h->keys[s]   = key;
+  h->values[s] = value;
+  h->len++;
+}
+
+bool phys_hash_remove(phys_hash_t* h, u64 key)
+{
+  if (h->len == 0) { return false; }
+  u32 mask = h->cap -1;
+  u32 i    = phys_hash_slot(h, key);
+  while (h->keys[i] != key)
+  {
+    if (h->keys[i] == PHYS_HASH_EMPTY) { return false; }
+    i = (i + 1) & mask;
+  }
+
+  // shift back following keys that would be unreachable with i empty
+  // a key can move to i if its home slot isnt in (i, j]
+  for (u32 j = (i + 1) & mask; h->keys[j] != PHYS_HASH_EMPTY; j = (j + 1) & mask)
+  {
+    u32  home = phys_hash_slot(h, h->keys[j]);
+    bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+    if (stays) { continue; }
+    h->keys[i]   = h->keys[j];
+    h->values[i] = h->values[j];
+    i = j;
+  }
+  h->keys[i] = PHYS_HASH_EMPTY;
+  h->len--;
+  return true;
+}
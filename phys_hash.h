@@ -0,0 +1,47 @@
+#ifndef PHYS_PHYS_HASH_H
+#define PHYS_PHYS_HASH_H
+
+#include "global/global.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: key of unused slots, cant be used as key
+#define PHYS_HASH_EMPTY   UINT64_MAX
+
+// @DOC: hashmap u64 key -> u32 value, open addressing with linear probing
+//       removing shifts the following keys back, so there are no tombstones and probing stays short
+//       only grows, once more than half full, so adding and removing the same keys doesnt allocate
+//       growing gets counted in phys_alloc_count
+typedef struct
+{
+  u64* keys;    // stb_ds arr, its length is cap, PHYS_HASH_EMPTY for unused slots
+  u32* values;  // stb_ds arr, same length as keys
+  u32  cap;     // 0 or power of 2
+  u32  len;     // number of keys in map
+  u32  shift;   // 64 - log2(cap), see phys_hash_slot()
+
+}phys_hash_t;
+#define PHYS_HASH_T_INIT()   { .keys = NULL, .values = NULL, .cap = 0, .len = 0, .shift = 64 }
+
+// @DOC: free all memory of map
+void phys_hash_clear(phys_hash_t* h);
+// @DOC: make room for len keys, without growing again
+//       len: number of keys the map should be able to hold
+void phys_hash_reserve(phys_hash_t* h, u32 len);
+// @DOC: get pointer to the value of key, NULL if key isnt in map
+//       valid until the next phys_hash_put() / phys_hash_remove()
+u32* phys_hash_get(phys_hash_t* h, u64 key);
+// @DOC: add key, key cant be in map already
+//       key:   anything but PHYS_HASH_EMPTY
+//       value: value for key
+void phys_hash_put(phys_hash_t* h, u64 key, u32 value);
+// @DOC: remove key, returns false if key wasnt in map
+bool phys_hash_remove(phys_hash_t* h, u64 key);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif
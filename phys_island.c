@@ -0,0 +1,147 @@
+#include "phys/phys_island.h"
+#include "phys/phys_arena.h"
+#include "phys/phys_world.h"  // phys_obj_combination_t
+
+#include "stb/stb_ds.h"
+#include <float.h>
+
+
+// rigidbody pairs in contact, idx's into phys_objs
+phys_obj_combination_t* island_contact_arr = NULL;
+u32                     island_contact_arr_len = 0;
+
+// union-find, per rigidbody, idx's relative to the first rigidbody
+u32* island_parent_arr = NULL;
+// island per root, -1 if not root or not in any island
+int* island_root_arr   = NULL;
+// island per rigidbody, -1 if skipped
+int* island_obj_island_arr = NULL;
+u32  island_obj_island_arr_len = 0;
+
+phys_island_t* island_arr = NULL;
+u32            island_arr_len = 0;
+u32*           island_objs_arr = NULL;
+u32            island_objs_arr_len = 0;
+
+
+void phys_island_clear()
+{
+  ARRFREE(island_contact_arr);
+  island_contact_arr_len = 0;
+  ARRFREE(island_parent_arr);
+  ARRFREE(island_root_arr);
+  ARRFREE(island_obj_island_arr);
+  island_obj_island_arr_len = 0;
+  ARRFREE(island_arr);
+  island_arr_len = 0;
+  ARRFREE(island_objs_arr);
+  island_objs_arr_len = 0;
+}
+
+void phys_island_begin()
+{
+  arrsetlen(island_contact_arr, 0);
+  island_contact_arr_len = 0;
+}
+
+void phys_island_add_contact(int a, int b)
+{
+  phys_obj_combination_t c = { .a = a, .b = b };
+  PHYS_ARRPUT(island_contact_arr, c);
+  island_contact_arr_len++;
+}
+
+static u32 phys_island_find(u32 i)
+{
+  while (island_parent_arr[i] != i)
+  {
+    island_parent_arr[i] = island_parent_arr[island_parent_arr[i]]; // path halving
+    i = island_parent_arr[i];
+  }
+  return i;
+}
+
+void phys_island_build(phys_obj_t* objs, u32 objs_len, u32 static_len, bool skip_sleeping)
+{
+  u32 rb_len = objs_len - static_len;
+  PHYS_ARRSETLEN(island_parent_arr, rb_len);
+  PHYS_ARRSETLEN(island_root_arr,   rb_len);
+  PHYS_ARRSETLEN(island_obj_island_arr, rb_len);
+  island_obj_island_arr_len = rb_len;
+  arrsetlen(island_arr, 0);
+  island_arr_len = 0;
+  arrsetlen(island_objs_arr, 0);
+  island_objs_arr_len = 0;
+
+  for (u32 i = 0; i < rb_len; ++i)
+  {
+    island_parent_arr[i] = i;
+    island_root_arr[i]   = -1;
+    island_obj_island_arr[i] = -1;
+  }
+
+  // ---- connect ----
+  // lower root wins, so islands dont depend on contact order
+  for (u32 i = 0; i < island_contact_arr_len; ++i)
+  {
+    phys_obj_combination_t* c = &island_contact_arr[i];
+    u32 a = phys_island_find((u32)c->a - static_len);
+    u32 b = phys_island_find((u32)c->b - static_len);
+    if (a == b) { continue; }
+    if (a < b) { island_parent_arr[b] = a; }
+    else       { island_parent_arr[a] = b; }
+  }
+
+  // ---- count ----
+  for (u32 i = 0; i < rb_len; ++i)
+  {
+    phys_obj_t* obj = &objs[static_len + i];
+    if (skip_sleeping && obj->rb.is_sleeping) { continue; }
+
+    u32 root = phys_island_find(i);
+    if (island_root_arr[root] < 0)
+    {
+      phys_island_t island = { .start = 0, .len = 0, .min_sleep_time = FLT_MAX };
+      PHYS_ARRPUT(island_arr, island);
+      island_root_arr[root] = (int)island_arr_len++;
+    }
+    phys_island_t* island = &island_arr[island_root_arr[root]];
+    island->len++;
+    island->min_sleep_time = MIN(island->min_sleep_time, obj->rb.sleep_time);
+  }
+  u32 start = 0;
+  for (u32 i = 0; i < island_arr_len; ++i)
+  {
+    island_arr[i].start = start;
+    start += island_arr[i].len;
+    island_arr[i].len = 0;
+  }
+
+  // ---- fill ----
+  PHYS_ARRSETLEN(island_objs_arr, start);
+  island_objs_arr_len = start;
+  for (u32 i = 0; i < rb_len; ++i)
+  {
+    if (skip_sleeping && objs[static_len + i].rb.is_sleeping) { continue; }
+    int island_idx = island_root_arr[phys_island_find(i)];
+    phys_island_t* island = &island_arr[island_idx];
+    island_objs_arr[island->start + island->len++] = static_len + i;
+    island_obj_island_arr[i] = island_idx;
+  }
+}
+
+phys_island_t* phys_island_get_arr(u32* len)
+{
+  *len = island_arr_len;
+  return island_arr;
+}
+u32* phys_island_get_objs(u32* len)
+{
+  *len = island_objs_arr_len;
+  return island_objs_arr;
+}
+int* phys_island_get_obj_islands(u32* len)
+{
+  *len = island_obj_island_arr_len;
+  return island_obj_island_arr;
+}
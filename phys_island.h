@@ -0,0 +1,52 @@
+#ifndef PHYS_PHYS_ISLAND_H
+#define PHYS_PHYS_ISLAND_H
+
+#include "global/global.h"
+#include "phys/phys_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: group of rigidbodies touching each other, directly or through other rigidbodies
+//       static objs dont connect islands, two boxes lying on the same floor are two islands
+typedef struct
+{
+  u32 start;          // first obj idx in island obj arr, see phys_island_get_objs()
+  u32 len;            // number of objs in island
+  f32 min_sleep_time; // lowest rigidbody_t.sleep_time of all objs in island
+
+}phys_island_t;
+
+// @DOC: free all island memory
+void phys_island_clear();
+
+// @DOC: remove all contacts, call before adding the contacts of a step
+void phys_island_begin();
+// @DOC: add contact between two rigidbodies, connects their islands
+//       a, b: idx's into phys_objs array, both with rigidbody
+void phys_island_add_contact(int a, int b);
+// @DOC: group all rigidbodies into islands, using the contacts added since phys_island_begin()
+//       islands are ordered by their first obj, objs in an island by their idx
+//       objs:       phys_objs array, static objs first, then rigidbodies
+//       objs_len:   length of objs
+//       static_len: number of static objs at the start of objs
+//       skip_sleeping: sleeping rigidbodies dont get put in any island
+void phys_island_build(phys_obj_t* objs, u32 objs_len, u32 static_len, bool skip_sleeping);
+
+// @DOC: get islands from last phys_island_build()
+//       len: gets set to arr's length
+phys_island_t* phys_island_get_arr(u32* len);
+// @DOC: get obj idx's of all islands, phys_island_t.start / len index into it
+//       len: gets set to arr's length
+u32* phys_island_get_objs(u32* len);
+// @DOC: get island of every rigidbody, idx into phys_island_get_arr() or -1 if it got skipped
+//       arr[i] is the island of the obj at idx static_len + i in the objs passed to phys_island_build()
+//       len: gets set to arr's length
+int* phys_island_get_obj_islands(u32* len);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif
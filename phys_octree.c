@@ -0,0 +1,319 @@
+#include "phys/phys_octree.h"
+#include "phys/phys_arena.h"
+
+#include "stb/stb_ds.h"
+#include <float.h>
+
+// items tested at once in phys_octree_query_aabb()
+#define PHYS_OCTREE_HITS_MAX  64
+
+
+void phys_octree_clear(phys_octree_t* tree)
+{
+  ARRFREE(tree->nodes);
+  tree->nodes_len = 0;
+  tree->depth     = 0;
+  ARRFREE(tree->items);
+  tree->items_len = 0;
+  ARRFREE(tree->tmp);
+  for (int a = 0; a < 3; ++a)
+  {
+    ARRFREE(tree->items_min[a]);
+    ARRFREE(tree->items_max[a]);
+  }
+}
+
+// ---- build ----
+
+// which child an item goes into, 8 if its too big and stays in the node
+static int phys_octree_item_octant(phys_bvh_build_item_t* item, vec3 center, f32 half)
+{
+  // child cells have half the size, loose bounds twice that
+  // so item fits if its center is in the cell and it isnt bigger than the cell
+  f32 child_half = half * 0.5f;
+  int octant = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    if ((item->max[i] - item->min[i]) * 0.5f > child_half) { return 8; }
+    if ((item->min[i] + item->max[i]) * 0.5f >= center[i]) { octant |= 1 << i; }
+  }
+  return octant;
+}
+
+static int phys_octree_build_node(phys_octree_t* tree, u32 start, u32 end, vec3 center, f32 half, int depth)
+{
+  phys_octree_node_t n;
+  for (int i = 0; i < 8; ++i) { n.children[i] = -1; }
+  n.items_start = start;
+  n.items_len   = end - start;
+  vec3_copy(VEC3( FLT_MAX), n.min);
+  vec3_copy(VEC3(-FLT_MAX), n.max);
+  for (u32 i = start; i < end; ++i)
+  {
+    for (int a = 0; a < 3; ++a)
+    {
+      n.min[a] = MIN(n.min[a], tree->items[i].min[a]);
+      n.max[a] = MAX(n.max[a], tree->items[i].max[a]);
+    }
+  }
+  PHYS_ARRPUT(tree->nodes, n);
+  int idx = (int)tree->nodes_len++;
+  tree->depth = MAX(tree->depth, depth);
+
+  if (end - start <= tree->leaf_capacity || depth >= tree->max_depth) { return idx; }
+
+  // ---- sort items by octant ----
+  // counting sort, items staying in node first, then octant 0 - 7
+  u32 count[9] = { 0 };
+  for (u32 i = start; i < end; ++i)
+  { count[phys_octree_item_octant(&tree->items[i], center, half)]++; }
+  u32 offset[9];
+  u32 octant_start[8];
+  offset[8] = start;
+  u32 next  = start + count[8];
+  for (int o = 0; o < 8; ++o)
+  {
+    offset[o]       = next;
+    octant_start[o] = next;
+    next += count[o];
+  }
+
+  for (u32 i = start; i < end; ++i)
+  {
+    int o = phys_octree_item_octant(&tree->items[i], center, half);
+    tree->tmp[offset[o]++] = tree->items[i];
+  }
+  memcpy(tree->items + start, tree->tmp + start, sizeof(phys_bvh_build_item_t) * (end - start));
+  tree->nodes[idx].items_len = count[8];
+
+  // ---- children ----
+  f32 child_half = half * 0.5f;
+  for (int o = 0; o < 8; ++o)
+  {
+    if (count[o] <= 0) { continue; }
+    vec3 child_center;
+    for (int a = 0; a < 3; ++a)
+    { child_center[a] = center[a] + ((o >> a) & 1 ? child_half : -child_half); }
+    int child = phys_octree_build_node(tree, octant_start[o], octant_start[o] + count[o], child_center, child_half, depth +1);
+    tree->nodes[idx].children[o] = child;  // nodes can get realloc'd
+  }
+  return idx;
+}
+
+void phys_octree_build(phys_octree_t* tree, phys_bvh_build_item_t* items, u32 items_len)
+{
+  ASSERT(tree->max_depth >= 0 && tree->max_depth <= PHYS_OCTREE_MAX_DEPTH);
+  ASSERT(tree->leaf_capacity > 0);
+
+  arrsetlen(tree->nodes, 0);
+  tree->nodes_len = 0;
+  tree->depth     = 0;
+  PHYS_ARRSETLEN(tree->items, items_len);
+  PHYS_ARRSETLEN(tree->tmp,   items_len);
+  tree->items_len = items_len;
+  if (items_len <= 0) { return; }
+  memcpy(tree->items, items, sizeof(phys_bvh_build_item_t) * items_len);
+
+  // root cell is a cube around all items
+  vec3 min = {  FLT_MAX,  FLT_MAX,  FLT_MAX };
+  vec3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+  for (u32 i = 0; i < items_len; ++i)
+  {
+    for (int a = 0; a < 3; ++a)
+    {
+      min[a] = MIN(min[a], items[i].min[a]);
+      max[a] = MAX(max[a], items[i].max[a]);
+    }
+  }
+  vec3 center;
+  f32  half = 0.0f;
+  for (int a = 0; a < 3; ++a)
+  {
+    center[a] = (min[a] + max[a]) * 0.5f;
+    half      = MAX(half, (max[a] - min[a]) * 0.5f);
+  }
+
+  phys_octree_build_node(tree, 0, items_len, center, half, 0);
+
+  for (int a = 0; a < 3; ++a)
+  {
+    PHYS_ARRSETLEN(tree->items_min[a], items_len);
+    PHYS_ARRSETLEN(tree->items_max[a], items_len);
+    for (u32 i = 0; i < items_len; ++i)
+    {
+      tree->items_min[a][i] = tree->items[i].min[a];
+      tree->items_max[a][i] = tree->items[i].max[a];
+    }
+  }
+}
+
+// ---- queries ----
+
+void phys_octree_query_aabb(phys_octree_t* tree, vec3 min, vec3 max, phys_bvh_query_callback* callback, void* data)
+{
+  if (tree->nodes_len <= 0) { return; }
+
+  int stack[PHYS_OCTREE_STACK_MAX];
+  int stack_len = 0;
+  stack[stack_len++] = 0;
+  while (stack_len > 0)
+  {
+    phys_octree_node_t* n = &tree->nodes[stack[--stack_len]];
+    if (!phys_bvh_aabb_overlap(n->min, n->max, min, max)) { continue; }
+
+    u32 items_end = n->items_start + n->items_len;
+    for (u32 start = n->items_start; start < items_end; start += PHYS_OCTREE_HITS_MAX)
+    {
+      u32 hits[PHYS_OCTREE_HITS_MAX];
+      u32 hits_len = phys_bvh_aabb_overlap_arr(min, max, tree->items_min, tree->items_max, 
+                                               start, MIN(start + PHYS_OCTREE_HITS_MAX, items_end), hits);
+      for (u32 i = 0; i < hits_len; ++i)
+      {
+        if (!callback(tree->items[hits[i]].user, data)) { return; }
+      }
+    }
+    for (int o = 0; o < 8; ++o)
+    {
+      if (n->children[o] < 0) { continue; }
+      ASSERT(stack_len < PHYS_OCTREE_STACK_MAX);
+      stack[stack_len++] = n->children[o];
+    }
+  }
+}
+
+void phys_octree_query_ray(phys_octree_t* tree, ray_t* ray, phys_bvh_query_callback* callback, void* data)
+{
+  if (tree->nodes_len <= 0) { return; }
+
+  vec3 inv_dir = { 1.0f / ray->dir[0], 1.0f / ray->dir[1], 1.0f / ray->dir[2] };
+  f32  max_dist = ray->len <= 0.0f ? FLT_MAX : ray->len;
+
+  int stack[PHYS_OCTREE_STACK_MAX];
+  int stack_len = 0;
+  stack[stack_len++] = 0;
+  while (stack_len > 0)
+  {
+    phys_octree_node_t* n = &tree->nodes[stack[--stack_len]];
+    if (!phys_bvh_ray_v_aabb(ray->pos, inv_dir, max_dist, n->min, n->max)) { continue; }
+
+    for (u32 i = n->items_start; i < n->items_start + n->items_len; ++i)
+    {
+      phys_bvh_build_item_t* item = &tree->items[i];
+      if (!phys_bvh_ray_v_aabb(ray->pos, inv_dir, max_dist, item->min, item->max)) { continue; }
+      if (!callback(item->user, data)) { return; }
+    }
+    for (int o = 0; o < 8; ++o)
+    {
+      if (n->children[o] < 0) { continue; }
+      ASSERT(stack_len < PHYS_OCTREE_STACK_MAX);
+      stack[stack_len++] = n->children[o];
+    }
+  }
+}
+
+f32 phys_octree_cast_ray(phys_octree_t* tree, ray_t* ray, f32 max_dist, phys_bvh_ray_callback* callback, void* data)
+{
+  vec3 ext = { 0.0f, 0.0f, 0.0f };
+  return phys_octree_cast_aabb(tree, ray, ext, max_dist, callback, data);
+}
+
+f32 phys_octree_cast_aabb(phys_octree_t* tree, ray_t* ray, vec3 ext, f32 max_dist, phys_bvh_ray_callback* callback, void* data)
+{
+  if (tree->nodes_len <= 0) { return max_dist; }
+
+  vec3 inv_dir = { 1.0f / ray->dir[0], 1.0f / ray->dir[1], 1.0f / ray->dir[2] };
+
+  int stack[PHYS_OCTREE_STACK_MAX];
+  f32 stack_dist[PHYS_OCTREE_STACK_MAX];
+  int stack_len = 0;
+  f32 root_dist = phys_bvh_ray_v_aabb_ext_dist(ray->pos, inv_dir, max_dist, tree->nodes[0].min, tree->nodes[0].max, ext);
+  if (root_dist == FLT_MAX) { return max_dist; }
+  stack[stack_len]        = 0;
+  stack_dist[stack_len++] = root_dist;
+  while (stack_len > 0)
+  {
+    --stack_len;
+    if (stack_dist[stack_len] > max_dist) { continue; }
+    phys_octree_node_t* n = &tree->nodes[stack[stack_len]];
+
+    for (u32 i = n->items_start; i < n->items_start + n->items_len; ++i)
+    {
+      phys_bvh_build_item_t* item = &tree->items[i];
+      if (phys_bvh_ray_v_aabb_ext_dist(ray->pos, inv_dir, max_dist, item->min, item->max, ext) == FLT_MAX) { continue; }
+      max_dist = callback(item->user, max_dist, data);
+      if (max_dist < 0.0f) { return max_dist; }
+    }
+
+    // children sorted farthest first, so the closest gets popped first
+    int children[8];
+    f32 dists[8];
+    int children_len = 0;
+    for (int o = 0; o < 8; ++o)
+    {
+      int c = n->children[o];
+      if (c < 0) { continue; }
+      f32 d = phys_bvh_ray_v_aabb_ext_dist(ray->pos, inv_dir, max_dist, tree->nodes[c].min, tree->nodes[c].max, ext);
+      if (d == FLT_MAX) { continue; }
+      int j = children_len++;
+      for (; j > 0 && dists[j -1] < d; --j)
+      {
+        children[j] = children[j -1];
+        dists[j]    = dists[j -1];
+      }
+      children[j] = c;
+      dists[j]    = d;
+    }
+    ASSERT(stack_len + children_len <= PHYS_OCTREE_STACK_MAX);
+    for (int c = 0; c < children_len; ++c)
+    {
+      stack[stack_len]        = children[c];
+      stack_dist[stack_len++] = dists[c];
+    }
+  }
+  return max_dist;
+}
+
+void phys_octree_cast_ray_packet(phys_octree_t* tree, phys_ray_packet_t* packet, phys_bvh_packet_callback* callback, void* data)
+{
+  if (tree->nodes_len <= 0) { return; }
+
+  // nodes get tested again when popped, max_dist of the lanes might have shrunk
+  int stack[PHYS_OCTREE_STACK_MAX];
+  int stack_len = 0;
+  stack[stack_len++] = 0;
+  while (stack_len > 0)
+  {
+    phys_octree_node_t* n = &tree->nodes[stack[--stack_len]];
+    if (!phys_bvh_ray_packet_v_aabb(packet, n->min, n->max, NULL)) { continue; }
+
+    for (u32 i = n->items_start; i < n->items_start + n->items_len; ++i)
+    {
+      phys_bvh_build_item_t* item = &tree->items[i];
+      int lanes = phys_bvh_ray_packet_v_aabb(packet, item->min, item->max, NULL);
+      if (lanes) { callback(item->user, lanes, data); }
+    }
+
+    // children sorted farthest first, so the closest gets popped first
+    int children[8];
+    f32 dists[8];
+    int children_len = 0;
+    for (int o = 0; o < 8; ++o)
+    {
+      int c = n->children[o];
+      if (c < 0) { continue; }
+      f32 d = FLT_MAX;
+      if (!phys_bvh_ray_packet_v_aabb(packet, tree->nodes[c].min, tree->nodes[c].max, &d)) { continue; }
+      int j = children_len++;
+      for (; j > 0 && dists[j -1] < d; --j)
+      {
+        children[j] = children[j -1];
+        dists[j]    = dists[j -1];
+      }
+      children[j] = c;
+      dists[j]    = d;
+    }
+    ASSERT(stack_len + children_len <= PHYS_OCTREE_STACK_MAX);
+    for (int c = 0; c < children_len; ++c)
+    { stack[stack_len++] = children[c]; }
+  }
+}
@@ -0,0 +1,93 @@
+#ifndef PHYS_PHYS_OCTREE_H
+#define PHYS_PHYS_OCTREE_H
+
+#include "global/global.h"
+#include "phys/phys_types.h"
+#include "phys/phys_bvh.h"  // phys_bvh_build_item_t, phys_bvh_query_callback, phys_bvh_ray_callback
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: max value for phys_octree_t.max_depth
+#define PHYS_OCTREE_MAX_DEPTH  16
+// @DOC: max nodes waiting to be checked when traversing the tree
+#define PHYS_OCTREE_STACK_MAX  (7 * PHYS_OCTREE_MAX_DEPTH + 8)
+
+// @DOC: node in phys_octree_t
+typedef struct
+{
+  vec3 min;           // bounds of all items in node and its children
+  vec3 max;           // bounds of all items in node and its children
+  int  children[8];   // -1 if octant has no items
+  u32  items_start;   // first item in phys_octree_t.items
+  u32  items_len;     // items that didnt fit into a child
+
+}phys_octree_node_t;
+
+// @DOC: loose octree, every node's bounds are twice its cell size
+//       so every item goes into the cell containing its center, as long as it isnt bigger than the cell
+//       items too big for any child stay in the node
+//       gets built once from all items, meant for static objs
+typedef struct
+{
+  int max_depth;      // deepest level nodes get split to, root is 0
+  u32 leaf_capacity;  // nodes with more items than this get split
+
+  phys_octree_node_t* nodes;    // [0] is root
+  u32 nodes_len;
+  int depth;                    // deepest node in tree, 0 for only root
+
+  phys_bvh_build_item_t* items; // sorted by node
+  u32 items_len;
+  phys_bvh_build_item_t* tmp;   // used while building
+  f32* items_min[3];            // aabb's of items packed per axis, see phys_bvh_aabb_overlap_arr()
+  f32* items_max[3];
+
+}phys_octree_t;
+#define PHYS_OCTREE_T_INIT()  \
+{                             \
+  .max_depth     = 8,         \
+  .leaf_capacity = 8,         \
+  .nodes         = NULL,      \
+  .nodes_len     = 0,         \
+  .depth         = 0,         \
+  .items         = NULL,      \
+  .items_len     = 0,         \
+  .tmp           = NULL,      \
+  .items_min     = { NULL },  \
+  .items_max     = { NULL },  \
+}
+
+// @DOC: free all memory of tree, keeps max_depth and leaf_capacity
+void phys_octree_clear(phys_octree_t* tree);
+
+// @DOC: clear tree and build it from all items
+//       items:     same as for phys_bvh_build(), gets copied
+//       items_len: length of items
+void phys_octree_build(phys_octree_t* tree, phys_bvh_build_item_t* items, u32 items_len);
+
+// @DOC: call callback for every item overlapping aabb
+//       min, max: aabb to check against
+//       callback: gets called with every items user data
+//       data:     gets passed to callback
+void phys_octree_query_aabb(phys_octree_t* tree, vec3 min, vec3 max, phys_bvh_query_callback* callback, void* data);
+// @DOC: call callback for every item whichs aabb gets hit by ray
+//       ray:      ray->len <= 0.0f means infinite length
+//       callback: gets called with every items user data
+//       data:     gets passed to callback
+void phys_octree_query_ray(phys_octree_t* tree, ray_t* ray, phys_bvh_query_callback* callback, void* data);
+// @DOC: cast ray through tree front to back, same as phys_bvh_cast_ray()
+//       children get visited closest first, nodes and items past max_dist get skipped
+//       returns the last max_dist
+f32 phys_octree_cast_ray(phys_octree_t* tree, ray_t* ray, f32 max_dist, phys_bvh_ray_callback* callback, void* data);
+// @DOC: cast aabb through tree front to back, same as phys_bvh_cast_aabb()
+f32 phys_octree_cast_aabb(phys_octree_t* tree, ray_t* ray, vec3 ext, f32 max_dist, phys_bvh_ray_callback* callback, void* data);
+// @DOC: cast all rays of packet through tree together, same as phys_bvh_cast_ray_packet()
+void phys_octree_cast_ray_packet(phys_octree_t* tree, phys_ray_packet_t* packet, phys_bvh_packet_callback* callback, void* data);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif
@@ -0,0 +1,109 @@
+#include "phys/phys_overlap.h"
+#include "phys/phys_world.h"
+#include "phys/phys_broadphase.h"
+#include "phys/phys_collision.h"
+#include "phys/phys_bvh.h"       // phys_bvh_aabb_overlap()
+
+
+typedef struct
+{
+  phys_obj_t* arr;
+  bool        is_sphere;  // sphere query, otherwise aabb
+  vec3        pos;        // sphere center
+  f32         radius;
+  vec3        min;        // query aabb, bounds of the sphere if is_sphere
+  vec3        max;
+  u32         layer_mask;
+  int*        out;
+  int         out_max;
+  int         len;
+}phys_overlap_t;
+
+// gets called for every obj whichs aabb overlaps the query's aabb
+// returns false once out is full, which stops the query
+static bool phys_overlap_callback(int obj_idx, void* data)
+{
+  phys_overlap_t* q = data;
+  phys_obj_t* obj = &q->arr[obj_idx];
+  if (!(q->layer_mask & PHYS_LAYER_BIT(obj->layer))) { return true; }
+  if (!PHYS_OBJ_HAS_COLLIDER(obj) || obj->collider.is_trigger) { return true; }
+
+  // leafs of the rigidbody tree are fattened, so the broadphase only narrows it down
+  if (obj->collider.type == PHYS_COLLIDER_SPHERE)
+  {
+    vec3 center, closest;
+    vec3_add(PHYS_OBJ_POS(obj), obj->collider.offset, center);
+    f32 radius = obj->collider.bounds_radius;
+    if (q->is_sphere)
+    {
+      radius += q->radius;
+      vec3_copy(q->pos, closest);
+    }
+    else { phys_util_closest_point_aabb(q->min, q->max, center, closest); }
+    vec3 d;
+    vec3_sub(closest, center, d);
+    if (vec3_dot(d, d) > radius * radius) { return true; }
+  }
+  else
+  {
+    vec3 min, max;
+    phys_obj_get_world_aabb(obj, min, max);
+    if (q->is_sphere)
+    {
+      vec3 closest, d;
+      phys_util_closest_point_aabb(min, max, q->pos, closest);
+      vec3_sub(closest, q->pos, d);
+      if (vec3_dot(d, d) > q->radius * q->radius) { return true; }
+    }
+    else if (!phys_bvh_aabb_overlap(min, max, q->min, q->max)) { return true; }
+  }
+
+  q->out[q->len++] = obj->entity_idx;
+  return q->len < q->out_max;
+}
+
+static int phys_overlap_query(phys_overlap_t* q)
+{
+  if (q->out_max <= 0) { return 0; }
+  u32 len = 0;
+  q->arr = phys_get_obj_arr(&len);
+  q->len = 0;
+  phys_broadphase_query_aabb(q->min, q->max, phys_overlap_callback, q);
+  return q->len;
+}
+
+int phys_overlap_sphere(vec3 pos, f32 radius, u32 layer_mask, int* out, int out_max)
+{
+  phys_overlap_t q = 
+  {
+    .is_sphere  = true,
+    .pos        = { pos[0], pos[1], pos[2] },
+    .radius     = radius,
+    .min        = { pos[0] - radius, pos[1] - radius, pos[2] - radius },
+    .max        = { pos[0] + radius, pos[1] + radius, pos[2] + radius },
+    .layer_mask = layer_mask,
+    .out        = out,
+    .out_max    = out_max,
+  };
+  return phys_overlap_query(&q);
+}
+
+int phys_overlap_aabb(vec3 min, vec3 max, u32 layer_mask, int* out, int out_max)
+{
+  phys_overlap_t q = 
+  {
+    .is_sphere  = false,
+    .min        = { min[0], min[1], min[2] },
+    .max        = { max[0], max[1], max[2] },
+    .layer_mask = layer_mask,
+    .out        = out,
+    .out_max    = out_max,
+  };
+  return phys_overlap_query(&q);
+}
+
+int phys_overlap_point(vec3 point, u32 layer_mask, int* out, int out_max)
+{
+  // aabb with no size, closest point on it is the point itself
+  return phys_overlap_aabb(point, point, layer_mask, out, out_max);
+}
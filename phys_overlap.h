@@ -0,0 +1,33 @@
+#ifndef PHYS_PHYS_OVERLAP_H
+#define PHYS_PHYS_OVERLAP_H
+
+#include "global/global.h"
+#include "phys/phys_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: overlap queries, get all objects touching a shape
+//       only objs with collider, triggers get skipped, same as phys_ray_cast()
+//       goes through the broadphase trees, doesnt allocate
+//       layer_mask: layers to check, bit per layer, see PHYS_LAYER_BIT(), PHYS_LAYER_MASK_ALL for all
+//       out:        gets filled with the entity_idx of every obj found, in no particular order
+//       out_max:    length of out, query stops once its full
+//       returns number of entity_idx's written to out, if its out_max there might be more
+
+// @DOC: get objs overlapping sphere
+//       pos, radius: sphere in world space
+int phys_overlap_sphere(vec3 pos, f32 radius, u32 layer_mask, int* out, int out_max);
+// @DOC: get objs overlapping aabb
+//       min, max: aabb in world space
+int phys_overlap_aabb(vec3 min, vec3 max, u32 layer_mask, int* out, int out_max);
+// @DOC: get objs containing point, i.e. spawn point checks
+//       point: position in world space
+int phys_overlap_point(vec3 point, u32 layer_mask, int* out, int out_max);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif
@@ -3,92 +3,163 @@
 #include "phys/phys_types.h"
 #include "phys_world.h"
 #include "phys_collision.h"
+#include "phys_broadphase.h"
+#include "phys_threads.h"
 #include "phys_debug_draw.h"
 
 #include "stb/stb_ds.h"
 
 
-// @TODO: @OPTIMIZE: optimize this, chunks
-bool phys_ray_cast_dbg(ray_t* ray, ray_hit_t* out, const char* _file, const char* _func, const int _line)
-{
-  (void)_file; (void)_func; (void)_line;
-  u32 len = 0;
-  phys_obj_t* arr = phys_get_obj_arr(&len);
+// ray_t.mask_arr put into a hash set on the stack, so checking an obj doesnt go through all of them
+// longer mask_arr's than PHYS_RAY_IGNORE_MAX get checked one by one
+#define PHYS_RAY_IGNORE_MAX     32
+#define PHYS_RAY_IGNORE_SLOTS   64  // power of 2, twice PHYS_RAY_IGNORE_MAX so probing stays short
+#define PHYS_RAY_IGNORE_SHIFT   26  // 32 - log2(PHYS_RAY_IGNORE_SLOTS)
 
+typedef struct
+{
+  int  ids[PHYS_RAY_IGNORE_SLOTS];
+  u64  used;      // bit per slot
+  int* arr;       // mask_arr if its too long for the set, otherwise NULL
+  int  arr_len;
+}phys_ray_ignore_t;
 
-  ray_hit_t* hit_arr = NULL;
-  u32        hit_arr_len = 0;
-
-  for (int i = 0; i < (int)len; ++i)
+// fibonacci hashing, close entity id's end up spread out
+static u32 phys_ray_ignore_slot(int id)
+{
+  return ((u32)id * 2654435761u) >> PHYS_RAY_IGNORE_SHIFT;
+}
+static void phys_ray_ignore_init(phys_ray_ignore_t* ignore, ray_t* ray)
+{
+  ignore->used    = 0;
+  ignore->arr     = NULL;
+  ignore->arr_len = 0;
+  if (!ray->mask_arr || ray->mask_arr_len <= 0) { return; }
+  if (ray->mask_arr_len > PHYS_RAY_IGNORE_MAX)
   {
-    phys_obj_t* obj = &arr[i];
-   
-    if (ray->mask_arr && ray->mask_arr_len > 0)
-    {
-      bool skip = false;
-      for (int m = 0; m < ray->mask_arr_len; ++m)
-      { if (obj->entity_idx == ray->mask_arr[m]) { skip = true; break; } }
-      if (skip) { continue; }
-    }
-    
-    if (!PHYS_OBJ_HAS_COLLIDER(obj) || obj->collider.is_trigger) { continue; }
-
-    // f32  dist = 0;
-    // vec3 hit_point;
-    ray_hit_t hit;
-    switch (obj->collider.type)
+    ignore->arr     = ray->mask_arr;
+    ignore->arr_len = ray->mask_arr_len;
+    return;
+  }
+  for (int m = 0; m < ray->mask_arr_len; ++m)
+  {
+    int id = ray->mask_arr[m];
+    u32 s  = phys_ray_ignore_slot(id);
+    while ((ignore->used >> s) & 1)
     {
-      case PHYS_COLLIDER_SPHERE:
-        if ( phys_collision_check_ray_v_sphere_obj(ray, obj, &hit) ) // &dist, hit_point) )
-        {
-          hit.entity_idx = obj->entity_idx,
-          arrput(hit_arr, hit);
-          hit_arr_len++;
-        }
-        break;
-      
-      case PHYS_COLLIDER_BOX:
-        if ( phys_collision_check_ray_v_aabb_obj(ray, obj, &hit) ) // &dist, hit_point) )
-        {
-          hit.entity_idx = obj->entity_idx,
-          arrput(hit_arr, hit);
-          hit_arr_len++;
-        }
-        break;
+      if (ignore->ids[s] == id) { break; }
+      s = (s + 1) & (PHYS_RAY_IGNORE_SLOTS -1);
     }
+    ignore->ids[s] = id;
+    ignore->used  |= 1ull << s;
+  }
+}
+static bool phys_ray_ignore_has(phys_ray_ignore_t* ignore, int id)
+{
+  if (ignore->arr)
+  {
+    for (int m = 0; m < ignore->arr_len; ++m)
+    { if (ignore->arr[m] == id) { return true; } }
+    return false;
+  }
+  if (!ignore->used) { return false; }
+  for (u32 s = phys_ray_ignore_slot(id); (ignore->used >> s) & 1; s = (s + 1) & (PHYS_RAY_IGNORE_SLOTS -1))
+  {
+    if (ignore->ids[s] == id) { return true; }
   }
+  return false;
+}
 
-  // no hits
-  if (hit_arr_len <= 0) { goto no_hit_exit; }
+typedef struct
+{
+  ray_t*             ray;
+  phys_ray_ignore_t* ignore;
+  phys_obj_t*        arr;
+  ray_hit_t          hit;   // closest hit so far, hit.hit false if none
+}phys_ray_cast_data_t;
 
+// objs without collider, triggers, excluded layers and ignored entities dont get hit
+static bool phys_ray_skip_obj(ray_t* ray, phys_ray_ignore_t* ignore, phys_obj_t* obj)
+{
+  if (ray->exclude_layers & PHYS_LAYER_BIT(obj->layer))  { return true; }
+  if (!PHYS_OBJ_HAS_COLLIDER(obj) || obj->collider.is_trigger) { return true; }
+  return phys_ray_ignore_has(ignore, obj->entity_idx);
+}
 
-  // get closest hit
-  int idx = 0;
-  for (int i = 0; i < (int)hit_arr_len; ++i)
+// check ray against obj, keeps the hit in best if its closer
+// returns true if best got set
+static bool phys_ray_cast_obj(ray_t* ray, phys_ray_ignore_t* ignore, phys_obj_t* obj, f32 max_dist, ray_hit_t* best)
+{
+  if (phys_ray_skip_obj(ray, ignore, obj)) { return false; }
+
+  ray_hit_t hit;
+  bool is_hit = false;
+  switch (obj->collider.type)
   {
-    if (hit_arr[i].dist < hit_arr[idx].dist) { idx = i; }
+    case PHYS_COLLIDER_SPHERE:
+      is_hit = phys_collision_check_ray_v_sphere_obj(ray, obj, &hit);
+      break;
+    
+    case PHYS_COLLIDER_BOX:
+      is_hit = phys_collision_check_ray_v_aabb_obj(ray, obj, &hit);
+      break;
   }
+  // nan dist if pos is on a face the ray is parallel to
+  if (!is_hit || !(hit.dist <= max_dist)) { return false; }
+  // same dist as the closest so far, keep the first
+  if (best->hit && hit.dist >= best->dist) { return false; }
+
+  hit.hit        = true;
+  hit.entity_idx = obj->entity_idx;
+  *best = hit;
+  return true;
+}
+
+// gets called for every obj whichs aabb the ray hits, closest first
+// returns dist of closest hit so far, so objs further away get skipped
+static f32 phys_ray_cast_callback(int obj_idx, f32 max_dist, void* data)
+{
+  phys_ray_cast_data_t* d = data;
+  if (!phys_ray_cast_obj(d->ray, d->ignore, &d->arr[obj_idx], max_dist, &d->hit)) { return max_dist; }
+  return d->hit.dist;
+}
+
+bool phys_ray_cast_dbg(ray_t* ray, ray_hit_t* out, const char* _file, const char* _func, const int _line)
+{
+  (void)_file; (void)_func; (void)_line;
+  u32 len = 0;
+  phys_ray_ignore_t ignore;
+  phys_ray_ignore_init(&ignore, ray);
+  phys_ray_cast_data_t data = 
+  {
+    .ray    = ray,
+    .ignore = &ignore,
+    .arr    = phys_get_obj_arr(&len),
+    .hit    = { .hit = false },
+  };
+
+  // front to back through the broadphase trees, starting at ray->len
+  // every hit shrinks the max dist, so only objs in front of it get checked after
+  phys_broadphase_cast_ray(ray, phys_ray_cast_callback, &data);
+
+  // no hits
+  if (!data.hit.hit) { goto no_hit_exit; }
 
   // set out to hit
-  *out = hit_arr[idx];
-  // if len <= 0 ignore len
-  out->hit = ray->len <= 0.0f || out->dist <= ray->len;
-  if (!out->hit) { goto no_hit_exit; }
+  *out = data.hit;
 
   // debug lines on hit
   if (ray->draw_debug)
   {
-    debug_draw_line_t(ray->pos, hit_arr[idx].hit_point, RGB_F(0, 1, 1), 1.0f);
-    debug_draw_sphere_t(hit_arr[idx].hit_point, 0.1f, RGB_F(0, 1, 0), 1.0f);
+    debug_draw_line_t(ray->pos, out->hit_point, RGB_F(0, 1, 1), 1.0f);
+    debug_draw_sphere_t(out->hit_point, 0.1f, RGB_F(0, 1, 0), 1.0f);
     vec3 norm;
-    vec3_copy(hit_arr[idx].hit_point, norm);
-    vec3_add(norm, hit_arr[idx].normal, norm);
-    debug_draw_line_t(hit_arr[idx].hit_point, norm, RGB_F(0, 1, 0), 1.0f);
+    vec3_copy(out->hit_point, norm);
+    vec3_add(norm, out->normal, norm);
+    debug_draw_line_t(out->hit_point, norm, RGB_F(0, 1, 0), 1.0f);
   }
-  
-  ARRFREE(hit_arr);    
 
-  return out->hit;
+  return true;
 
 no_hit_exit:;
   if (ray->draw_debug)
@@ -104,6 +175,204 @@ no_hit_exit:;
   return false;
 }
 
+// ---- shape casts ----
+
+typedef struct
+{
+  ray_t*             ray;
+  phys_ray_ignore_t* ignore;
+  phys_obj_t*        arr;
+  int                type;    // PHYS_COLLIDER_SPHERE or PHYS_COLLIDER_BOX
+  f32                radius;  // if sphere
+  vec3               ext;     // half extents if box, radius on every axis if sphere
+  ray_hit_t          hit;     // closest hit so far, hit.hit false if none
+}phys_shape_cast_data_t;
+
+// gets called for every obj whichs aabb the swept shape touches, closest first
+// returns dist of closest hit so far, same as phys_ray_cast_callback()
+static f32 phys_shape_cast_callback(int obj_idx, f32 max_dist, void* data)
+{
+  phys_shape_cast_data_t* d = data;
+  phys_obj_t* obj = &d->arr[obj_idx];
+  if (phys_ray_skip_obj(d->ray, d->ignore, obj)) { return max_dist; }
+
+  ray_hit_t hit;
+  bool is_hit = false;
+  if (obj->collider.type == PHYS_COLLIDER_SPHERE)
+  {
+    vec3 pos;
+    vec3_add(PHYS_OBJ_POS(obj), obj->collider.offset, pos);
+    f32 s_rad = obj->collider.bounds_radius;
+    is_hit = d->type == PHYS_COLLIDER_SPHERE ? phys_collision_cast_sphere_v_sphere(d->ray, d->radius, pos, s_rad, &hit) :
+                                               phys_collision_cast_aabb_v_sphere(d->ray, d->ext, pos, s_rad, &hit);
+  }
+  else
+  {
+    vec3 min, max;
+    phys_obj_get_world_aabb(obj, min, max);
+    is_hit = d->type == PHYS_COLLIDER_SPHERE ? phys_collision_cast_sphere_v_aabb(d->ray, d->radius, min, max, &hit) :
+                                               phys_collision_cast_aabb_v_aabb(d->ray, d->ext, min, max, &hit);
+  }
+  if (!is_hit || !(hit.dist <= max_dist)) { return max_dist; }
+  if (d->hit.hit && hit.dist >= d->hit.dist) { return max_dist; }
+
+  hit.hit        = true;
+  hit.entity_idx = obj->entity_idx;
+  d->hit = hit;
+  return hit.dist;
+}
+
+// sweep shape in d through the broadphase, same as phys_ray_cast_dbg()
+static bool phys_shape_cast(phys_shape_cast_data_t* d, ray_hit_t* out)
+{
+  u32 len = 0;
+  phys_ray_ignore_t ignore;
+  phys_ray_ignore_init(&ignore, d->ray);
+  d->ignore = &ignore;
+  d->arr    = phys_get_obj_arr(&len);
+  d->hit.hit = false;
+
+  // node aabb's grown by the shape, so the center's path is a ray again
+  phys_broadphase_cast_aabb(d->ray, d->ext, phys_shape_cast_callback, d);
+
+  ray_t* ray = d->ray;
+  if (ray->draw_debug)
+  {
+    f32 dist = d->hit.hit ? d->hit.dist : (ray->len <= 0.0f ? 25.0f : ray->len);
+    vec3 end;
+    vec3_mul_f(ray->dir, dist, end);
+    vec3_add(end, ray->pos, end);
+    vec3 color = { 0.0f, 1.0f, 1.0f };
+    if (!d->hit.hit) { color[0] = 1.0f; color[1] = 0.0f; color[2] = 0.0f; }
+    debug_draw_line(ray->pos, end, color);
+    if (d->type == PHYS_COLLIDER_SPHERE)
+    { debug_draw_sphere_t(end, d->radius, color, 1.0f); }
+    else
+    {
+      vec3 min, max;
+      vec3_sub(end, d->ext, min);
+      vec3_add(end, d->ext, max);
+      phys_debug_draw_aabb(min, max, color);
+    }
+    if (d->hit.hit)
+    {
+      vec3 norm;
+      vec3_add(d->hit.hit_point, d->hit.normal, norm);
+      debug_draw_line_t(d->hit.hit_point, norm, RGB_F(0, 1, 0), 1.0f);
+    }
+  }
+
+  if (!d->hit.hit) { return false; }
+  *out = d->hit;
+  return true;
+}
+
+bool phys_sphere_cast(ray_t* ray, f32 radius, ray_hit_t* out)
+{
+  phys_shape_cast_data_t d = 
+  {
+    .ray    = ray,
+    .type   = PHYS_COLLIDER_SPHERE,
+    .radius = radius,
+    .ext    = { radius, radius, radius },
+  };
+  return phys_shape_cast(&d, out);
+}
+
+bool phys_box_cast(ray_t* ray, vec3 half_ext, ray_hit_t* out)
+{
+  phys_shape_cast_data_t d = 
+  {
+    .ray    = ray,
+    .type   = PHYS_COLLIDER_BOX,
+    .radius = 0.0f,
+    .ext    = { half_ext[0], half_ext[1], half_ext[2] },
+  };
+  return phys_shape_cast(&d, out);
+}
+
+// ---- batches ----
+
+// packets per phys_threads_run() job
+#define PHYS_RAY_BATCH_CHUNK  8
+
+typedef struct
+{
+  phys_ray_packet_t* packet;
+  phys_ray_ignore_t* ignore;    // one per lane
+  phys_obj_t*        arr;
+  ray_hit_t*         out;       // one per lane
+}phys_ray_packet_data_t;
+
+typedef struct
+{
+  ray_t*      rays;
+  u32         rays_len;
+  ray_hit_t*  out;
+  phys_obj_t* arr;
+}phys_ray_batch_t;
+
+// check obj against all lanes whichs ray hit its aabb, shrinks their max_dist on hit
+static void phys_ray_cast_packet_callback(int obj_idx, int lanes, void* data)
+{
+  phys_ray_packet_data_t* d = data;
+  phys_obj_t* obj = &d->arr[obj_idx];
+  for (int l = 0; lanes != 0; ++l, lanes >>= 1)
+  {
+    if (!(lanes & 1)) { continue; }
+    if (phys_ray_cast_obj(d->packet->rays[l], &d->ignore[l], obj, d->packet->max_dist[l], &d->out[l]))
+    { d->packet->max_dist[l] = d->out[l].dist; }
+  }
+}
+
+// cast packets [start, end), every packet only writes its own out's
+static void phys_ray_cast_batch_job(u32 start, u32 end, u32 thread_idx, void* data)
+{
+  (void)thread_idx;
+  phys_ray_batch_t* b = data;
+  for (u32 p = start; p < end; ++p)
+  {
+    u32 first = p * PHYS_SIMD_WIDTH;
+    u32 len   = MIN(PHYS_SIMD_WIDTH, b->rays_len - first);
+    phys_ray_ignore_t ignore[PHYS_SIMD_WIDTH];
+    for (u32 i = 0; i < len; ++i)
+    { 
+      ray_hit_t none = { .hit = false, .dist = 0.0f, .entity_idx = -1 };
+      b->out[first + i] = none; 
+      phys_ray_ignore_init(&ignore[i], &b->rays[first + i]);
+    }
+
+    phys_ray_packet_t packet;
+    phys_ray_packet_init(&packet, &b->rays[first], len);
+    phys_ray_packet_data_t d = { .packet = &packet, .ignore = ignore, .arr = b->arr, .out = &b->out[first] };
+    phys_broadphase_cast_ray_packet(&packet, phys_ray_cast_packet_callback, &d);
+  }
+}
+
+int phys_ray_cast_batch(ray_t* rays, int rays_len, ray_hit_t* out)
+{
+  if (rays_len <= 0) { return 0; }
+
+  // the static tree gets built lazily, not on the threads
+  phys_broadphase_build_static();
+
+  u32 len = 0;
+  phys_ray_batch_t b = 
+  {
+    .rays     = rays,
+    .rays_len = (u32)rays_len,
+    .out      = out,
+    .arr      = phys_get_obj_arr(&len),
+  };
+  u32 packets_len = (b.rays_len + PHYS_SIMD_WIDTH -1) / PHYS_SIMD_WIDTH;
+  phys_threads_run(packets_len, PHYS_RAY_BATCH_CHUNK, phys_ray_cast_batch_job, &b);
+
+  int hits = 0;
+  for (int i = 0; i < rays_len; ++i) 
+  { hits += out[i].hit; }
+  return hits;
+}
+
 // // @TODO: @OPTIMIZE: optimize this, chunks
 // bool phys_ray_cast_mask_dbg(ray_t* ray, ray_hit_t* out, u32* mask_arr, int mask_arr_len, const char* _file, const char* _func, const int _line)
 // {
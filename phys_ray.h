@@ -9,16 +9,45 @@ extern "C" {
 #endif
 
 
-// @DOC: check every object against ray
+// @DOC: get closest object hit by ray
+//       goes through the broadphase trees front to back, stops at the closest hit
 //       returns true if hit 
 //       out gets set to hit info
 //       ignores entity id's given in mask_arr
 //       ignore single id: phys_ray_cast_mask(..., &id, 1)
+//       ignores objs on layers set in ray->exclude_layers, see PHYS_LAYER_BIT()
+//       doesnt allocate, only the closest hit gets kept
 //       ! set ray->len to <= 0 for inmfinite length, 
 //         or to max length for ray
 bool phys_ray_cast_dbg(ray_t* ray, ray_hit_t* out, const char* _file, const char* _func, const int _line);
 #define phys_ray_cast(ray, out) phys_ray_cast_dbg(ray, out, __FILE__, __func__, __LINE__)
 
+// @DOC: sweep sphere along ray, get closest object it touches
+//       goes through the broadphase trees front to back, same as phys_ray_cast()
+//       ray:       ray->pos is the spheres center at the start, ray->len, mask_arr and exclude_layers same as phys_ray_cast()
+//       radius:    radius of the sphere
+//       out->dist:      time of impact, dist the center moved until touching, 0 if it starts overlapping
+//       out->hit_point: contact point on the objs collider
+//       out->normal:    surface normal of the obj at hit_point, -ray->dir if it starts overlapping
+//       returns true if hit
+bool phys_sphere_cast(ray_t* ray, f32 radius, ray_hit_t* out);
+// @DOC: sweep aabb along ray, get closest object it touches, same as phys_sphere_cast()
+//       ray:       ray->pos is the aabb's center at the start
+//       half_ext:  half extents of the aabb
+//       returns true if hit
+bool phys_box_cast(ray_t* ray, vec3 half_ext, ray_hit_t* out);
+
+// @DOC: get closest hit for every ray, same result as phys_ray_cast() for each
+//       rays get cast PHYS_SIMD_WIDTH at a time, each node gets tested against all of them at once
+//       so rays close to each other, i.e. spreads or cones, share most of the traversal
+//       packets get spread over phys_settings_t.threads, dont call during phys_update()
+//       ray->draw_debug gets ignored
+//       rays:     rays to cast, ray->len, ray->mask_arr and ray->exclude_layers same as phys_ray_cast()
+//       rays_len: number of rays
+//       out:      gets set to hit info for every ray, out[i].hit false if rays[i] hit nothing
+//       returns number of rays that hit
+int phys_ray_cast_batch(ray_t* rays, int rays_len, ray_hit_t* out);
+
 // // @DOC: check every object against ray
 // //       returns true if hit 
 // //       out gets set to hit info
@@ -5,65 +5,98 @@
 
 // ---- collision response ----
 
+// impact force, both objs get pushed apart by their mass ratio
+static void phys_collision_resolution_force(phys_obj_t* obj0, phys_obj_t* obj1, vec3 dist)
+{
+  const f32 force_mult = 500.0f; // 500.0f; // 1000.0f;
+	
+  if (PHYS_OBJ_HAS_RIGIDBODY(obj1))
+	{
+		f32 ratio0 = obj1->rb.mass / obj0->rb.mass;
+		f32 ratio1 = obj0->rb.mass / obj1->rb.mass;
+    
+    vec3 f0, f1;
+		vec3_mul_f(dist,  force_mult * ratio0, f0);
+		vec3_mul_f(dist, -force_mult * ratio1, f1);
+
+    vec3_add(PHYS_OBJ_FORCE(obj0), f0, PHYS_OBJ_FORCE(obj0));
+    vec3_add(PHYS_OBJ_FORCE(obj1), f1, PHYS_OBJ_FORCE(obj1)); 
+	}
+	else
+	{
+		vec3 f0;
+		// 1.9 * force_mult, because not elastic
+		vec3_mul_f(dist, force_mult * 2.0f, f0);
+    vec3_add(PHYS_OBJ_FORCE(obj0), f0, PHYS_OBJ_FORCE(obj0));
+	}
+}
+
 
 void phys_collision_resolution(phys_obj_t* obj0, phys_obj_t* obj1, collision_info_t info)
 {
   
   bool obj0_has_rb = PHYS_OBJ_HAS_RIGIDBODY(obj0);
-  bool obj1_has_rb = PHYS_OBJ_HAS_RIGIDBODY(obj1);
 
 	if (!obj0_has_rb) { return; }
 	
-	// vec3_copy(obj0->pos, obj0->last_pos); // set last frames pos // gets done in phys_dynamic // gets done in phys_dynamics
+	// vec3_copy(PHYS_OBJ_POS(obj0), PHYS_OBJ_LAST_POS(obj0)); // set last frames pos // gets done in phys_dynamic // gets done in phys_dynamics
   
   // position correction
 	vec3 dist;
 	vec3_mul_f(info.direction, info.depth, dist);  // info.depth * 0.5f
   
   // old, phys_update_old():
-  vec3_add(obj0->pos, dist, obj0->pos);
+  vec3_add(PHYS_OBJ_POS(obj0), dist, PHYS_OBJ_POS(obj0));
   
   // // new, phys_update_new():
   // if (obj1_has_rb)
   // {
   //   vec3_mul_f(dist, 0.5f, dist);
-  //   vec3_add(obj0->pos, dist, obj0->pos);
-  // 	vec3_sub(obj1->pos, dist, obj1->pos);
+  //   vec3_add(PHYS_OBJ_POS(obj0), dist, PHYS_OBJ_POS(obj0));
+  // 	vec3_sub(PHYS_OBJ_POS(obj1), dist, PHYS_OBJ_POS(obj1));
   // }
   // else
   // {
   //   // vec3_mul_f(dist, 2.0f, dist);
-  //   vec3_add(obj0->pos, dist, obj0->pos);
+  //   vec3_add(PHYS_OBJ_POS(obj0), dist, PHYS_OBJ_POS(obj0));
   // }
 
 	// impact force
-  // old, phys_update_old():
-  const f32 force_mult = 500.0f; // 500.0f; // 1000.0f;
-	
-  // // new, phys_update_new():
-  // const f32 force_mult = 500.0f; // 500.0f; // 1000.0f;
-  // const f32 force_mult = 500.0f * 2.0f; // 500.0f; // 1000.0f;
-	
-  if (obj1_has_rb)
-	{
-		f32 ratio0 = obj1->rb.mass / obj0->rb.mass;
-		f32 ratio1 = obj0->rb.mass / obj1->rb.mass;
-    
-    vec3 f0, f1;
-		vec3_mul_f(dist,  force_mult * ratio0, f0);
-		vec3_mul_f(dist, -force_mult * ratio1, f1);
+  phys_collision_resolution_force(obj0, obj1, dist);
+}
 
-    vec3_add(obj0->rb.force, f0, obj0->rb.force);
-    vec3_add(obj1->rb.force, f1, obj1->rb.force); 
-	}
-	else
-	{
-		vec3 f0;
-		// 1.9 * force_mult, because not elastic
-		vec3_mul_f(dist, force_mult * 2.0f, f0);
-    vec3_add(obj0->rb.force, f0, obj0->rb.force);
-	}
+void phys_collision_resolution_pair(phys_obj_t* obj0, phys_obj_t* obj1, collision_info_t info)
+{
+	if (!PHYS_OBJ_HAS_RIGIDBODY(obj0)) { return; }
+  if (!PHYS_OBJ_HAS_RIGIDBODY(obj1))
+  {
+    phys_collision_resolution(obj0, obj1, info);
+    return;
+  }
+
+  // position correction
+	vec3 dist;
+	vec3_mul_f(info.direction, info.depth, dist);
+
+  // @NOTE: splitting 50 / 50 made stacks vibrate, the lower obj got pushed into the ground,
+  //        so grounded objs dont get moved by objs that arent
+  f32 share0 = obj1->rb.mass / (obj0->rb.mass + obj1->rb.mass);
+  bool grounded0 = obj0->collider.is_grounded;
+  bool grounded1 = obj1->collider.is_grounded;
+  if      (grounded0 && !grounded1) { share0 = 0.0f; }
+  else if (grounded1 && !grounded0) { share0 = 1.0f; }
+
+  vec3 dist0, dist1;
+  vec3_mul_f(dist, share0, dist0);
+  vec3_mul_f(dist, 1.0f - share0, dist1);
+  vec3_add(PHYS_OBJ_POS(obj0), dist0, PHYS_OBJ_POS(obj0));
+  vec3_sub(PHYS_OBJ_POS(obj1), dist1, PHYS_OBJ_POS(obj1));
 
+	// impact force
+  // phys_update_old() resolves both directions, so both objs got the force twice, keep that
+  vec3 force_dist;
+  vec3_mul_f(dist, 2.0f, force_dist);
+  phys_collision_resolution_force(obj0, obj1, force_dist);
 }
 
 
@@ -76,16 +109,16 @@ void phys_collision_resolution(phys_obj_t* obj0, phys_obj_t* obj1, collision_inf
 // if (info.grounded) // (o1->is_dynamic && o0->is_grounded)
 // {
 // 	vec3 f;
-// 	vec3_mul_f(obj1->rb.velocity, 1, f);
+// 	vec3_mul_f(PHYS_OBJ_VELOCITY(obj1), 1, f);
 // 	// phys_obj_add_force(o0->idx, f);
-//   vec3_add(obj0->rb.velocity, f, obj0->rb.velocity);
+//   vec3_add(PHYS_OBJ_VELOCITY(obj0), f, PHYS_OBJ_VELOCITY(obj0));
 // }
 // if (o1->is_grounded) // (o1->is_dynamic && o0->is_grounded)
 // {
 // 	vec2 f;
 // 	vec2_mul_f(o0->velocity, 1, f);
 // 	// phys_obj_add_force(o1->idx, f);
-//   vec3_add(obj0->rb.velocity, f0);
+//   vec3_add(PHYS_OBJ_VELOCITY(obj0), f0);
 // }
 
 void phys_collision_response(phys_obj_t* obj0, phys_obj_t* obj1, collision_info_t info)
@@ -105,7 +138,7 @@ void phys_collision_response_resolve_position(phys_obj_t* obj0, phys_obj_t* obj1
 {
   // ERR_CHECK(obj->rb.mass > 1.0f, "mass: %f, id: %d\n", obj->rb.mass, obj->entity_idx);
   // PF("id: %d, mass: %f\n", obj->entity_idx, obj->rb.mass);
-  // PF("id: %d, ", obj->entity_idx); P_VEC3(obj->rb.velocity);
+  // PF("id: %d, ", obj->entity_idx); P_VEC3(PHYS_OBJ_VELOCITY(obj));
   // P_COLLIDER_TYPE_T(obj->collider.type);
   // P_COLLIDER_T(obj->collider);
   // P_RIGIDBODY_T(obj->rb);
@@ -138,12 +171,12 @@ void phys_collision_response_resolve_position(phys_obj_t* obj0, phys_obj_t* obj1
   if (obj0_has_rb) 
   {
     vec3_mul_f(correction, inv_mass0, delta0);
-    vec3_add(obj0->pos, delta0, obj0->pos);     
+    vec3_add(PHYS_OBJ_POS(obj0), delta0, PHYS_OBJ_POS(obj0));     
   }
   if (obj1_has_rb) 
   { 
     vec3_mul_f(correction, inv_mass1, delta1); 
-    vec3_sub(obj1->pos, delta1, obj1->pos);
+    vec3_sub(PHYS_OBJ_POS(obj1), delta1, PHYS_OBJ_POS(obj1));
   }
 }
 // taken from winterdev's 'IwEngine' https://github.com/IainWinter/IwEngine/blob/master/IwEngine
@@ -158,8 +191,8 @@ void phys_collision_response_resolve_velocity(phys_obj_t* obj0, phys_obj_t* obj1
   bool obj1_has_rb = PHYS_OBJ_HAS_RIGIDBODY(obj1);
 
   vec3 velocity0, velocity1;
-  vec3_copy(obj0_has_rb ? obj0->rb.velocity : VEC3(0), velocity0); 
-  vec3_copy(obj1_has_rb ? obj1->rb.velocity : VEC3(0), velocity1);
+  vec3_copy(obj0_has_rb ? PHYS_OBJ_VELOCITY(obj0) : VEC3(0), velocity0); 
+  vec3_copy(obj1_has_rb ? PHYS_OBJ_VELOCITY(obj1) : VEC3(0), velocity1);
   
   // P_VEC3(velocity0);
   // P_VEC3(velocity1);
@@ -250,16 +283,16 @@ void phys_collision_response_resolve_velocity(phys_obj_t* obj0, phys_obj_t* obj1
   if (obj0_has_rb)
   {
     // if (info.grounded) { velocity0[1] = MAX(velocity0[1], 0.0f); P_F32(velocity0[1]); }
-    vec3_mul_f(friction, inv_mass0, obj0->rb.velocity);
-    vec3_sub(obj0->rb.velocity, velocity0, obj0->rb.velocity);
+    vec3_mul_f(friction, inv_mass0, PHYS_OBJ_VELOCITY(obj0));
+    vec3_sub(PHYS_OBJ_VELOCITY(obj0), velocity0, PHYS_OBJ_VELOCITY(obj0));
   }
   if (obj1_has_rb)
   {
-    vec3_mul_f(friction, inv_mass1, obj1->rb.velocity);
-    vec3_add(obj1->rb.velocity, velocity1, obj1->rb.velocity);
+    vec3_mul_f(friction, inv_mass1, PHYS_OBJ_VELOCITY(obj1));
+    vec3_add(PHYS_OBJ_VELOCITY(obj1), velocity1, PHYS_OBJ_VELOCITY(obj1));
   }
 
-  // if (info.grounded) { obj0->rb.velocity[1] = MAX(obj0->rb.velocity[1], 0.0f); P_F32(obj0->rb.velocity[1]); }
+  // if (info.grounded) { PHYS_OBJ_VELOCITY(obj0)[1] = MAX(PHYS_OBJ_VELOCITY(obj0)[1], 0.0f); P_F32(PHYS_OBJ_VELOCITY(obj0)[1]); }
 
 }
 
@@ -308,15 +341,15 @@ void phys_collision_response_resolve_position(phys_obj_t* obj0, phys_obj_t* obj1
 
     // tmp
 	  vec3 obj0_pre_pos;
-    vec3_copy(obj0->pos, obj0_pre_pos);
+    vec3_copy(PHYS_OBJ_POS(obj0), obj0_pre_pos);
 
-    vec3_add(info.direction, obj0->pos, obj0->pos);
+    vec3_add(info.direction, PHYS_OBJ_POS(obj0), PHYS_OBJ_POS(obj0));
 
 		// vec3 norm_inv;
 		// vec3_copy(info.direction, norm_inv);
 		// vec3_negate(norm_inv);
 		// vec3_mul_f(norm_inv, scalar);
-		// vec3_add(norm_inv, e1->pos, e1->pos);
+		// vec3_add(norm_inv, PHYS_OBJ_POS(e1), PHYS_OBJ_POS(e1));
 
 		// f32 s2_dist = dist * s2_ratio;
 		// vec3 s2_dist_vec = { s2_dist, s2_dist, s2_dist };
@@ -324,14 +357,14 @@ void phys_collision_response_resolve_position(phys_obj_t* obj0, phys_obj_t* obj1
 
     // tmp
     vec3 obj1_pre_pos;
-    vec3_copy(obj1->pos, obj1_pre_pos);
+    vec3_copy(PHYS_OBJ_POS(obj1), obj1_pre_pos);
 
 		vec3 norm_inv;
 		vec3_copy(info.direction, norm_inv);
 		vec3_negate(norm_inv, norm_inv);
-		vec3_add(norm_inv, obj1->pos, obj1->pos);
+		vec3_add(norm_inv, PHYS_OBJ_POS(obj1), PHYS_OBJ_POS(obj1));
 
-		// vec3_add(info.direction, e2->pos, e2->pos);
+		// vec3_add(info.direction, PHYS_OBJ_POS(e2), PHYS_OBJ_POS(e2));
 
 
 	}
@@ -344,14 +377,14 @@ void phys_collision_response_resolve_position(phys_obj_t* obj0, phys_obj_t* obj1
 		// vec3_negate(norm_inv);
 		// vec3 dist_vec = { dist, dist, dist };
 		// vec3_mul(info.normal, dist_vec, offset);
-		// vec3_add(offset, e2->pos, e2->pos);
+		// vec3_add(offset, PHYS_OBJ_POS(e2), PHYS_OBJ_POS(e2));
 
-		vec3_add(info.direction, obj1->pos, obj1->pos);
+		vec3_add(info.direction, PHYS_OBJ_POS(obj1), PHYS_OBJ_POS(obj1));
 
 		vec3 norm_inv;
 		vec3_copy(info.direction, norm_inv);
 		vec3_negate(norm_inv, norm_inv);
-		vec3_add(norm_inv, obj1->pos, obj1->pos);
+		vec3_add(norm_inv, PHYS_OBJ_POS(obj1), PHYS_OBJ_POS(obj1));
 	}
 	else if (PHYS_OBJ_HAS_RIGIDBODY(obj0) && !PHYS_OBJ_HAS_RIGIDBODY(obj1))
 	{
@@ -359,15 +392,15 @@ void phys_collision_response_resolve_position(phys_obj_t* obj0, phys_obj_t* obj1
 		// vec3 offset;
 		// vec3 dist_vec = { dist, dist, dist };
 		// vec3_mul(info.normal, dist_vec, offset);
-		// vec3_add(offset, e1->pos, e1->pos);
+		// vec3_add(offset, PHYS_OBJ_POS(e1), PHYS_OBJ_POS(e1));
 
 		// vec3 norm_inv;
 		// vec3_copy(info.direction, norm_inv);
 		// vec3_negate(norm_inv);
 		// vec3_mul_f(norm_inv, scalar);
-		// vec3_add(norm_inv, e1->pos, e1->pos);
+		// vec3_add(norm_inv, PHYS_OBJ_POS(e1), PHYS_OBJ_POS(e1));
 
-		vec3_add(info.direction, obj0->pos, obj0->pos);
+		vec3_add(info.direction, PHYS_OBJ_POS(obj0), PHYS_OBJ_POS(obj0));
 	}
 }
 
@@ -383,7 +416,7 @@ void phys_collision_response_resolve_velocity(phys_obj_t* obj0, phys_obj_t* obj1
 	if (PHYS_OBJ_HAS_RIGIDBODY(obj0))
 	{
 		mass1 = obj0->rb.mass;
-		vec3_copy(obj0->rb.velocity, velocity1);
+		vec3_copy(PHYS_OBJ_VELOCITY(obj0), velocity1);
 	}
 	else // static
 	{
@@ -393,7 +426,7 @@ void phys_collision_response_resolve_velocity(phys_obj_t* obj0, phys_obj_t* obj1
 	if (PHYS_OBJ_HAS_RIGIDBODY(obj1))
 	{
 		mass2 = obj1->rb.mass;
-		vec3_copy(obj1->rb.velocity, velocity2);
+		vec3_copy(PHYS_OBJ_VELOCITY(obj1), velocity2);
 	}
 	else // static
 	{
@@ -441,26 +474,26 @@ void phys_collision_response_resolve_velocity(phys_obj_t* obj0, phys_obj_t* obj1
 	// set velocity
 	if (PHYS_OBJ_HAS_RIGIDBODY(obj0) && !PHYS_OBJ_HAS_RIGIDBODY(obj1))
 	{
-		// vec3_copy(v1, e1->rb.velocity);
+		// vec3_copy(v1, PHYS_OBJ_VELOCITY(e1));
 
 	  vec3_copy(info.direction, v1);
 		vec3_mul_f(v1, 10, v1);
-		vec3_copy(v1, obj0->rb.velocity);
-		// printf("s1 v: x: %.2f, y: %.2f, z: %.2f\n", e1->rb.velocity[0], e1->rb.velocity[1], e1->rb.velocity[2]);
+		vec3_copy(v1, PHYS_OBJ_VELOCITY(obj0));
+		// printf("s1 v: x: %.2f, y: %.2f, z: %.2f\n", PHYS_OBJ_VELOCITY(e1)[0], PHYS_OBJ_VELOCITY(e1)[1], PHYS_OBJ_VELOCITY(e1)[2]);
 	}
   else if (!PHYS_OBJ_HAS_RIGIDBODY(obj0) && PHYS_OBJ_HAS_RIGIDBODY(obj1))
 	{
-		// vec3_copy(v2, e2->rb.velocity);
+		// vec3_copy(v2, PHYS_OBJ_VELOCITY(e2));
 
 		vec3_copy(info.direction, v2);
 		vec3_mul_f(v2, 10, v2);
-		vec3_copy(v2, obj1->rb.velocity);
-		// printf("s2 v: x: %.2f, y: %.2f, z: %.2f\n", e2->rb.velocity[0], e2->rb.velocity[1], e2->rb.velocity[2]);
+		vec3_copy(v2, PHYS_OBJ_VELOCITY(obj1));
+		// printf("s2 v: x: %.2f, y: %.2f, z: %.2f\n", PHYS_OBJ_VELOCITY(e2)[0], PHYS_OBJ_VELOCITY(e2)[1], PHYS_OBJ_VELOCITY(e2)[2]);
 	}
   else if (PHYS_OBJ_HAS_RIGIDBODY(obj0) && PHYS_OBJ_HAS_RIGIDBODY(obj1))
 	{
-		// vec3_add(v1, e1->rb.velocity, e1->rb.velocity);
-		// vec3_add(v2, e2->rb.velocity, e2->rb.velocity);
+		// vec3_add(v1, PHYS_OBJ_VELOCITY(e1), PHYS_OBJ_VELOCITY(e1));
+		// vec3_add(v2, PHYS_OBJ_VELOCITY(e2), PHYS_OBJ_VELOCITY(e2));
 
 
 		vec3_copy(info.direction, v1);
@@ -471,7 +504,7 @@ void phys_collision_response_resolve_velocity(phys_obj_t* obj0, phys_obj_t* obj1
 
 		vec3_mul(v1, dir, v1);
 		// vec3_mul_f(v1, 10);
-		vec3_copy(v1, obj0->rb.velocity);
+		vec3_copy(v1, PHYS_OBJ_VELOCITY(obj0));
 
 
 		vec3_copy(info.direction, v2);
@@ -480,10 +513,10 @@ void phys_collision_response_resolve_velocity(phys_obj_t* obj0, phys_obj_t* obj1
 		vec3_mul(v2, dir, v2);
 		// vec3_mul_f(v2, 10);
 		// vec3_negate(v2); // ???
-		vec3_copy(v2, obj1->rb.velocity);
+		vec3_copy(v2, PHYS_OBJ_VELOCITY(obj1));
 
-		// printf("rb1: \"%s\", v: x: %.2f, y: %.2f, z: %.2f\n", e1->name, e1->rb.velocity[0], e1->rb.velocity[1], e1->rb.velocity[2]);
-		// printf("rb2: \"%s\", v: x: %.2f, y: %.2f, z: %.2f\n", e2->name, e2->rb.velocity[0], e2->rb.velocity[1], e2->rb.velocity[2]);
+		// printf("rb1: \"%s\", v: x: %.2f, y: %.2f, z: %.2f\n", e1->name, PHYS_OBJ_VELOCITY(e1)[0], PHYS_OBJ_VELOCITY(e1)[1], PHYS_OBJ_VELOCITY(e1)[2]);
+		// printf("rb2: \"%s\", v: x: %.2f, y: %.2f, z: %.2f\n", e2->name, PHYS_OBJ_VELOCITY(e2)[0], PHYS_OBJ_VELOCITY(e2)[1], PHYS_OBJ_VELOCITY(e2)[2]);
 	}
 }
 
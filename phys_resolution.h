@@ -3,6 +3,7 @@
 
 #include "global/global.h"
 #include "phys/phys_types.h" 
+#include "phys/phys_bodies.h"
 
 
 #ifdef __cplusplus
@@ -14,6 +15,14 @@ extern "C" {
 //       obj1: second object to have collided
 //       info: info about the collision, returned by one of phys_collision_check...()
 void phys_collision_resolution(phys_obj_t* obj0, phys_obj_t* obj1, collision_info_t info);
+// @DOC: same as phys_collision_resolution(), but resolves both sides, for checking every pair only once
+//       if both have rigidbodies the position correction gets split by mass,
+//       unless only one of them is grounded, then the other one gets moved all the way
+//       the impact force is doubled, to match phys_collision_resolution() getting called from both sides
+//       obj0: first object to have collided, needs rigidbody
+//       obj1: second object to have collided
+//       info: info about the collision, from obj0's side
+void phys_collision_resolution_pair(phys_obj_t* obj0, phys_obj_t* obj1, collision_info_t info);
 
 // @NOTE: old
 // void phys_collision_resolution(phys_obj_t* obj0, phys_obj_t* obj1, collision_info_t info);
@@ -0,0 +1,105 @@
+#ifndef PHYS_PHYS_SIMD_H
+#define PHYS_PHYS_SIMD_H
+
+#include "global/global.h"
+
+// @DOC: f32 lanes, picked at compile time, avx2 > sse2 > scalar
+//       define PHYS_NO_SIMD to always use the scalar version
+//       phys_f32x_t:    PHYS_SIMD_WIDTH f32's
+//       phys_maskx_t:   one bool per lane, from the compare / mask macros
+//       PHYS_SIMD_FMA:  defined if PHYS_F32X_FMADD() is a real fused multiply add
+
+#if defined(__AVX2__) && !defined(PHYS_NO_SIMD)
+
+#include <immintrin.h>
+
+#define PHYS_SIMD_AVX2
+#define PHYS_SIMD_WIDTH 8
+typedef __m256 phys_f32x_t;
+typedef __m256 phys_maskx_t;
+
+#define PHYS_F32X_LOAD(p)           _mm256_loadu_ps(p)
+#define PHYS_F32X_STORE(p, a)       _mm256_storeu_ps((p), (a))
+#define PHYS_F32X_SET1(f)           _mm256_set1_ps(f)
+#define PHYS_F32X_ADD(a, b)         _mm256_add_ps((a), (b))
+#define PHYS_F32X_SUB(a, b)         _mm256_sub_ps((a), (b))
+#define PHYS_F32X_MUL(a, b)         _mm256_mul_ps((a), (b))
+#define PHYS_F32X_MIN(a, b)         _mm256_min_ps((a), (b))
+#define PHYS_F32X_MAX(a, b)         _mm256_max_ps((a), (b))
+#define PHYS_F32X_SELECT(m, a, b)   _mm256_blendv_ps((b), (a), (m)) // m ? a : b
+#define PHYS_F32X_CMP_LE(a, b)      _mm256_cmp_ps((a), (b), _CMP_LE_OQ)
+#define PHYS_MASKX_AND(a, b)        _mm256_and_ps((a), (b))
+#define PHYS_MASKX_BITS(m)          _mm256_movemask_ps(m)             // bit per lane
+// a * b + c
+#ifdef __FMA__
+#define PHYS_SIMD_FMA
+#define PHYS_F32X_FMADD(a, b, c)    _mm256_fmadd_ps((a), (b), (c))
+#else
+#define PHYS_F32X_FMADD(a, b, c)    _mm256_add_ps(_mm256_mul_ps((a), (b)), (c))
+#endif
+
+// lanes where p[i] != 0, reads PHYS_SIMD_WIDTH u8's
+INLINE phys_maskx_t PHYS_MASKX_FROM_U8(const u8* p)
+{
+  __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)p));
+  return _mm256_castsi256_ps(_mm256_cmpgt_epi32(v, _mm256_setzero_si256()));
+}
+
+#elif (defined(__SSE2__) || defined(_M_X64)) && !defined(PHYS_NO_SIMD)
+
+#include <emmintrin.h>
+
+#define PHYS_SIMD_SSE2
+#define PHYS_SIMD_WIDTH 4
+typedef __m128 phys_f32x_t;
+typedef __m128 phys_maskx_t;
+
+#define PHYS_F32X_LOAD(p)           _mm_loadu_ps(p)
+#define PHYS_F32X_STORE(p, a)       _mm_storeu_ps((p), (a))
+#define PHYS_F32X_SET1(f)           _mm_set1_ps(f)
+#define PHYS_F32X_ADD(a, b)         _mm_add_ps((a), (b))
+#define PHYS_F32X_SUB(a, b)         _mm_sub_ps((a), (b))
+#define PHYS_F32X_MUL(a, b)         _mm_mul_ps((a), (b))
+#define PHYS_F32X_MIN(a, b)         _mm_min_ps((a), (b))
+#define PHYS_F32X_MAX(a, b)         _mm_max_ps((a), (b))
+#define PHYS_F32X_SELECT(m, a, b)   _mm_or_ps(_mm_and_ps((m), (a)), _mm_andnot_ps((m), (b)))
+#define PHYS_F32X_CMP_LE(a, b)      _mm_cmple_ps((a), (b))
+#define PHYS_MASKX_AND(a, b)        _mm_and_ps((a), (b))
+#define PHYS_MASKX_BITS(m)          _mm_movemask_ps(m)
+#define PHYS_F32X_FMADD(a, b, c)    _mm_add_ps(_mm_mul_ps((a), (b)), (c))
+
+INLINE phys_maskx_t PHYS_MASKX_FROM_U8(const u8* p)
+{
+  int bytes;
+  memcpy(&bytes, p, sizeof(int));
+  __m128i v = _mm_cvtsi32_si128(bytes);
+  v = _mm_unpacklo_epi8(v,  _mm_setzero_si128());
+  v = _mm_unpacklo_epi16(v, _mm_setzero_si128());
+  return _mm_castsi128_ps(_mm_cmpgt_epi32(v, _mm_setzero_si128()));
+}
+
+#else
+
+#define PHYS_SIMD_SCALAR
+#define PHYS_SIMD_WIDTH 1
+typedef f32  phys_f32x_t;
+typedef bool phys_maskx_t;
+
+#define PHYS_F32X_LOAD(p)           (*(p))
+#define PHYS_F32X_STORE(p, a)       (*(p) = (a))
+#define PHYS_F32X_SET1(f)           (f)
+#define PHYS_F32X_ADD(a, b)         ((a) + (b))
+#define PHYS_F32X_SUB(a, b)         ((a) - (b))
+#define PHYS_F32X_MUL(a, b)         ((a) * (b))
+#define PHYS_F32X_MIN(a, b)         MIN((a), (b))
+#define PHYS_F32X_MAX(a, b)         MAX((a), (b))
+#define PHYS_F32X_SELECT(m, a, b)   ((m) ? (a) : (b))
+#define PHYS_F32X_CMP_LE(a, b)      ((a) <= (b))
+#define PHYS_MASKX_AND(a, b)        ((a) && (b))
+#define PHYS_MASKX_BITS(m)          ((int)(m))
+#define PHYS_F32X_FMADD(a, b, c)    ((a) * (b) + (c))
+#define PHYS_MASKX_FROM_U8(p)       (*(p) != 0)
+
+#endif
+
+#endif
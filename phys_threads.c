@@ -0,0 +1,184 @@
+#include "phys/phys_threads.h"
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+  typedef HANDLE             phys_thread_t;
+  typedef CRITICAL_SECTION   phys_mutex_t;
+  typedef CONDITION_VARIABLE phys_cond_t;
+  #define PHYS_MUTEX_INIT(m)      InitializeCriticalSection(m)
+  #define PHYS_MUTEX_FREE(m)      DeleteCriticalSection(m)
+  #define PHYS_MUTEX_LOCK(m)      EnterCriticalSection(m)
+  #define PHYS_MUTEX_UNLOCK(m)    LeaveCriticalSection(m)
+  #define PHYS_COND_INIT(c)       InitializeConditionVariable(c)
+  #define PHYS_COND_FREE(c)
+  #define PHYS_COND_WAIT(c, m)    SleepConditionVariableCS(c, m, INFINITE)
+  #define PHYS_COND_BROADCAST(c)  WakeAllConditionVariable(c)
+  #define PHYS_ATOMIC_ADD(p, v)   ((u32)InterlockedExchangeAdd((volatile LONG*)(p), (LONG)(v)))
+#else
+  #include <pthread.h>
+  typedef pthread_t       phys_thread_t;
+  typedef pthread_mutex_t phys_mutex_t;
+  typedef pthread_cond_t  phys_cond_t;
+  #define PHYS_MUTEX_INIT(m)      pthread_mutex_init(m, NULL)
+  #define PHYS_MUTEX_FREE(m)      pthread_mutex_destroy(m)
+  #define PHYS_MUTEX_LOCK(m)      pthread_mutex_lock(m)
+  #define PHYS_MUTEX_UNLOCK(m)    pthread_mutex_unlock(m)
+  #define PHYS_COND_INIT(c)       pthread_cond_init(c, NULL)
+  #define PHYS_COND_FREE(c)       pthread_cond_destroy(c)
+  #define PHYS_COND_WAIT(c, m)    pthread_cond_wait(c, m)
+  #define PHYS_COND_BROADCAST(c)  pthread_cond_broadcast(c)
+  #define PHYS_ATOMIC_ADD(p, v)   __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+#endif
+
+
+phys_thread_t threads_arr[PHYS_THREADS_MAX];
+u32           threads_arr_len = 0;  // workers, without the calling thread
+
+phys_mutex_t threads_mutex;
+phys_cond_t  threads_start_cond;  // new job or quit
+phys_cond_t  threads_done_cond;   // all workers finished the job
+u32          threads_job_gen  = 0;// incremented for every job
+u32          threads_done     = 0;// workers done with current job
+bool         threads_quit     = false;
+
+// current job
+phys_threads_func* threads_job_func  = NULL;
+void*              threads_job_data  = NULL;
+u32                threads_job_len   = 0;
+u32                threads_job_chunk = 1;
+volatile u32       threads_job_next  = 0; // next item to hand out
+
+
+static void phys_threads_work(u32 thread_idx)
+{
+  while (true)
+  {
+    u32 start = PHYS_ATOMIC_ADD(&threads_job_next, threads_job_chunk);
+    if (start >= threads_job_len) { break; }
+    u32 end = MIN(start + threads_job_chunk, threads_job_len);
+    threads_job_func(start, end, thread_idx, threads_job_data);
+  }
+}
+
+static void phys_threads_worker(u32 thread_idx)
+{
+  u32 gen = 0;
+  PHYS_MUTEX_LOCK(&threads_mutex);
+  while (true)
+  {
+    while (threads_job_gen == gen && !threads_quit)
+    { PHYS_COND_WAIT(&threads_start_cond, &threads_mutex); }
+    if (threads_quit) { break; }
+    gen = threads_job_gen;
+    PHYS_MUTEX_UNLOCK(&threads_mutex);
+
+    phys_threads_work(thread_idx);
+
+    PHYS_MUTEX_LOCK(&threads_mutex);
+    threads_done++;
+    if (threads_done >= threads_arr_len) { PHYS_COND_BROADCAST(&threads_done_cond); }
+  }
+  PHYS_MUTEX_UNLOCK(&threads_mutex);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI phys_threads_entry(LPVOID arg)
+{
+  phys_threads_worker((u32)(uintptr_t)arg);
+  return 0;
+}
+#else
+static void* phys_threads_entry(void* arg)
+{
+  phys_threads_worker((u32)(uintptr_t)arg);
+  return NULL;
+}
+#endif
+
+void phys_threads_init(u32 threads_len)
+{
+  phys_threads_shutdown();
+  if (threads_len <= 1) { return; }
+  threads_len = MIN(threads_len, PHYS_THREADS_MAX +1);
+
+  PHYS_MUTEX_INIT(&threads_mutex);
+  PHYS_COND_INIT(&threads_start_cond);
+  PHYS_COND_INIT(&threads_done_cond);
+  threads_quit    = false;
+  threads_job_gen = 0;
+
+  // thread_idx 0 is the calling thread
+  for (u32 i = 0; i < threads_len -1; ++i)
+  {
+    #ifdef _WIN32
+    threads_arr[i] = CreateThread(NULL, 0, phys_threads_entry, (LPVOID)(uintptr_t)(i +1), 0, NULL);
+    ERR_CHECK(threads_arr[i] != NULL, "failed to create phys worker thread %u\n", i);
+    #else
+    int err = pthread_create(&threads_arr[i], NULL, phys_threads_entry, (void*)(uintptr_t)(i +1));
+    ERR_CHECK(err == 0, "failed to create phys worker thread %u\n", i);
+    #endif
+  }
+  threads_arr_len = threads_len -1;
+}
+
+void phys_threads_shutdown()
+{
+  if (threads_arr_len <= 0) { return; }
+
+  PHYS_MUTEX_LOCK(&threads_mutex);
+  threads_quit = true;
+  PHYS_COND_BROADCAST(&threads_start_cond);
+  PHYS_MUTEX_UNLOCK(&threads_mutex);
+
+  for (u32 i = 0; i < threads_arr_len; ++i)
+  {
+    #ifdef _WIN32
+    WaitForSingleObject(threads_arr[i], INFINITE);
+    CloseHandle(threads_arr[i]);
+    #else
+    pthread_join(threads_arr[i], NULL);
+    #endif
+  }
+  threads_arr_len = 0;
+
+  PHYS_COND_FREE(&threads_start_cond);
+  PHYS_COND_FREE(&threads_done_cond);
+  PHYS_MUTEX_FREE(&threads_mutex);
+}
+
+u32 phys_threads_get_count()
+{
+  return threads_arr_len +1;
+}
+
+void phys_threads_run(u32 len, u32 chunk, phys_threads_func* func, void* data)
+{
+  if (len <= 0) { return; }
+  chunk = MAX(chunk, 1);
+
+  // not worth waking the workers
+  if (threads_arr_len <= 0 || len <= chunk)
+  {
+    func(0, len, 0, data);
+    return;
+  }
+
+  PHYS_MUTEX_LOCK(&threads_mutex);
+  threads_job_func  = func;
+  threads_job_data  = data;
+  threads_job_len   = len;
+  threads_job_chunk = chunk;
+  threads_job_next  = 0;
+  threads_done      = 0;
+  threads_job_gen++;
+  PHYS_COND_BROADCAST(&threads_start_cond);
+  PHYS_MUTEX_UNLOCK(&threads_mutex);
+
+  phys_threads_work(0);
+
+  PHYS_MUTEX_LOCK(&threads_mutex);
+  while (threads_done < threads_arr_len)
+  { PHYS_COND_WAIT(&threads_done_cond, &threads_mutex); }
+  PHYS_MUTEX_UNLOCK(&threads_mutex);
+}
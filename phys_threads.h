@@ -0,0 +1,41 @@
+#ifndef PHYS_PHYS_THREADS_H
+#define PHYS_PHYS_THREADS_H
+
+#include "global/global.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: max worker threads, see phys_threads_init()
+#define PHYS_THREADS_MAX  64
+
+// @DOC: func type for phys_threads_run()
+//       start, end: range of items to process, [start, end)
+//       thread_idx: 0 for the calling thread, 1 - phys_threads_get_count() -1 for workers
+//       data:       data passed to phys_threads_run()
+typedef void (phys_threads_func)(u32 start, u32 end, u32 thread_idx, void* data);
+
+// @DOC: start fixed pool of worker threads, stops the old one if already started
+//       threads_len: threads working on phys_threads_run(), including the calling thread
+//                    0 or 1 means no workers, everything runs on the calling thread
+void phys_threads_init(u32 threads_len);
+// @DOC: stop and join all worker threads
+void phys_threads_shutdown();
+// @DOC: get number of threads working on phys_threads_run(), including the calling thread
+u32 phys_threads_get_count();
+
+// @DOC: call func for all items split into chunks, on the workers and the calling thread
+//       returns once all items are done, which thread gets which chunk changes every call
+//       so func should only write to data owned by the items it got
+//       len:   number of items
+//       chunk: items per call to func, at least 1
+//       func:  gets called with the range of items to process
+//       data:  gets passed to func
+void phys_threads_run(u32 len, u32 chunk, phys_threads_func* func, void* data);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif
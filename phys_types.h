@@ -89,26 +89,29 @@ typedef struct collider_t
     box_collider_t    box;
   };
 
-  collision_info_t* infos;  // all collision infos, because multiple collisions may occur in one frame
-  int infos_len;
+  vec3 bounds[2];     // aabb relative to pos + offset, scale included, see phys_obj_update_bounds(), PHYS_OBJ_POS()
+  f32  bounds_radius; // sphere radius times scale, 0 for box
 
 }collider_t;
 
 
-// @NOTE: doesnt print collision infos
 #define P_COLLIDER_T(a)       { P_LINE(); PF("collider_t: %s\n", #a); P_COLLIDER_TYPE_T((a).type); P_VEC3((a).offset); P_BOOL((a).is_trigger);  \
                                 if ((a).type == PHYS_COLLIDER_SPHERE) { P_SPHERE_COLLIDER_T((a).sphere); }                                      \
                                 if ((a).type == PHYS_COLLIDER_BOX)    { P_BOX_COLLIDER_T((a).box); } }                                  
 
 // @DOC: rigidbidy, all data needed to simulate dynamics
+// velocity and force are in phys_bodies_t, see PHYS_OBJ_VELOCITY()
 typedef struct rigidbody_t
 {
-  vec3 velocity;    // current velocity
-  vec3 force;       // also often called 'acceleration-accumulator'
   f32  mass;        // objs mass
   f32  drag;        // slows object constantly, the lower the more stronger
   f32  friction;    // scales drag when colliding, the lower the more friction, i.e. 0.0f <->  1.0f
 
+  bool is_sleeping; // at rest, doesnt get simulated or checked for collisions until woken up
+  f32  sleep_time;  // how long it has been moving slower than the sleep velocity
+  u32  sleep_island;// id shared by all objs that fell asleep together, they wake up together
+  u32  sleep_next;  // slot idx of the next obj in its sleep island, the last one links back to the first
+
   // @NOTE: part of the old resolution
   // f32  restitution;      // default: 1.0f
   // f32  static_friction;  // default: 0.0f
@@ -119,14 +122,16 @@ typedef struct rigidbody_t
 // @DOC: default values for rigidbody_t
 #define RIGIDBODY_T_INIT()  \
 {                           \
-  .velocity = { 0, 0, 0 },  \
-  .force    = { 0, 0, 0 },  \
   .mass     = 1.0f,         \
   .drag     = 0.3f,         \
   .friction = 0.1f,         \
+  .is_sleeping  = false,    \
+  .sleep_time   = 0.0f,     \
+  .sleep_island = 0,        \
+  .sleep_next   = 0,        \
 }
 
-#define P_RIGIDBODY_T(a)      { P_LINE(); PF("rigidbody_t: %s\n", #a); P_VEC3((a).velocity); P_VEC3((a).force);                       \
+#define P_RIGIDBODY_T(a)      { P_LINE(); PF("rigidbody_t: %s\n", #a);                                                              \
                                 P_F32((a).mass); P_F32((a).restitution); P_F32((a).static_friction); P_F32((a).dynamic_friction); }
 
 // @DOC: flag defining which 'components' a phys_obj_t has
@@ -135,6 +140,7 @@ typedef enum phys_obj_flag
   PHYS_HAS_RIGIDBODY = FLAG(0), 
   PHYS_HAS_BOX       = FLAG(1), 
   PHYS_HAS_SPHERE    = FLAG(2),
+  PHYS_REPORT_CONTACTS = FLAG(3), // contacts of obj show up in phys_get_contact_events()
 
 } phys_obj_flag;
 #define PHYS_OBJ_HAS_RIGIDBODY(obj) (HAS_FLAG((obj)->flags, PHYS_HAS_RIGIDBODY))
@@ -145,15 +151,56 @@ typedef enum phys_obj_flag
 #define P_PHYS_OBJ_FLAGS_T(a) { PF("phys_obj_flag: %s\n", #a);                                                       \
                                 PF("PHYS_HAS_RIGIDBODY: %s\n",  ((a) & PHYS_HAS_RIGIDBODY) ? "true" : "false");   \
                                 PF("PHYS_HAS_BOX: %s\n",        ((a) & PHYS_HAS_BOX)       ? "true" : "false");   \
-                                PF("PHYS_HAS_SPHERE: %s\n",     ((a) & PHYS_HAS_SPHERE)    ? "true" : "false"); }
+                                PF("PHYS_HAS_SPHERE: %s\n",     ((a) & PHYS_HAS_SPHERE)    ? "true" : "false");   \
+                                PF("PHYS_REPORT_CONTACTS: %s\n",((a) & PHYS_REPORT_CONTACTS) ? "true" : "false"); }
+
+// @DOC: how the broadphase finds overlapping pairs
+//       the aabb tree always gets kept up to date, as its also used for queries
+typedef enum phys_broadphase_type
+{
+  PHYS_BROADPHASE_BVH,  // query aabb tree for every rigidbody
+  PHYS_BROADPHASE_SAP,  // sweep-and-prune, sorted on x axis
+  PHYS_BROADPHASE_GRID, // spatial hash grid, rebuilt every frame, good for many similar sized rigidbodies
+
+}phys_broadphase_type;
+
+// @DOC: structure the static objs get put in, built once, rebuilt after static objs get added / removed
+typedef enum phys_static_type
+{
+  PHYS_STATIC_BVH,    // aabb tree, built top-down
+  PHYS_STATIC_OCTREE, // loose octree, good for level geometry spread out evenly
+
+}phys_static_type;
+
+// @DOC: collision layers, every phys_obj_t is on one, see phys_obj_t.layer
+//       PHYS_LAYERS_MAX:    number of layers, so a mask of all layers fits in a u32
+//       PHYS_LAYER_DEFAULT: layer objs get added on
+//       PHYS_LAYER_BIT():   bit of layer in a mask, i.e. ray_t.exclude_layers
+//       PHYS_LAYER_MASK_ALL: mask with every layer
+#define PHYS_LAYERS_MAX       32
+#define PHYS_LAYER_DEFAULT    0
+#define PHYS_LAYER_BIT(layer) (1u << (layer))
+#define PHYS_LAYER_MASK_ALL   0xFFFFFFFFu
+
+// @DOC: handle to a phys_obj_t, stays the same while the obj moves around in phys_objs
+//       idx: slot the obj is in
+//       gen: generation of the slot, removing the obj bumps it, so old handles to the slot become invalid
+typedef struct phys_handle_t
+{
+  u32 idx;
+  u32 gen;
+
+}phys_handle_t;
+// @DOC: handle that never points to a phys_obj_t, generations start at 1
+#define PHYS_HANDLE_T_INVALID() { .idx = 0, .gen = 0 }
+#define P_PHYS_HANDLE_T(a)    { PF("phys_handle_t: %s: idx: %u, gen: %u\n", #a, (a).idx, (a).gen); }
 
 // @DOC: the objs simulated and attached to an entity
+//       pos and last_pos are in phys_bodies_t, see PHYS_OBJ_POS()
 typedef struct phys_obj_t
 {
   int  entity_idx;  // id of entity the phys_obj_t simulates
-  vec3 pos;         // position
   vec3 scl;         // scale
-  vec3 last_pos;    // position, last frame
   // vec3 last_dir;    // last movement dir, in case pos & last_pos are same // @NOTE: old used in aabb_v_aabb_swept
   // no rotation, not supported
 
@@ -161,29 +208,35 @@ typedef struct phys_obj_t
   rigidbody_t rb;
   collider_t  collider;
 
-  u32 exclude_flag; // @TODO:
+  u32 layer;        // collision layer, 0 - PHYS_LAYERS_MAX -1, see PHYS_LAYER_BIT()
+  u32 layer_mask;   // layers obj collides with, bit per layer, also see phys_set_layer_collision()
+
+  int proxy_idx;    // idx of proxy in phys_broadphase.c, -1 if no collider
+  u32 slot_idx;     // idx of slot in phys_world.c, see phys_handle_t
 
 }phys_obj_t;
 #define PHYS_OBJ_T_INIT()     \
 {                             \
   .entity_idx = -1,           \
-  .pos        = { 0,  0, 0 }, \
   .scl        = { 1,  1, 1 }, \
-  .last_pos   = { 0,  0, 0 }, \
   .flags      = 0,            \
   .rb = RIGIDBODY_T_INIT(),   \
+  .layer      = PHYS_LAYER_DEFAULT, \
+  .layer_mask = PHYS_LAYER_MASK_ALL, \
+  .proxy_idx  = -1,           \
 }
 
 #define P_PHYS_OBJ_T(a)       { P_LINE();                                                                               \
-                                PF("phys_obj_t: %s\n", #a); P_U32((a)->entity_idx); P_VEC3((a)->pos); P_VEC3((a)->scl); \
+                                PF("phys_obj_t: %s\n", #a); P_U32((a)->entity_idx); P_VEC3(PHYS_OBJ_POS(a)); P_VEC3((a)->scl); \
                                 P_PHYS_OBJ_FLAGS_T((a)->flags); P_RIGIDBODY_T((a)->rb); P_COLLIDER_T((a)->collider);    \
                                 P_LINE(); }
 
-#define P_PHYS_OBJ_T_NAN(a)   { P_VEC3_NAN((a)->pos); P_VEC3_NAN((a)->scl);                 \
-                                P_VEC3_NAN((a)->rb.velocity); P_VEC3_NAN((a)->rb.force); }
+// the pos / velocity / force ones need phys_bodies.h
+#define P_PHYS_OBJ_T_NAN(a)   { P_VEC3_NAN(PHYS_OBJ_POS(a)); P_VEC3_NAN((a)->scl);                 \
+                                P_VEC3_NAN(PHYS_OBJ_VELOCITY(a)); P_VEC3_NAN(PHYS_OBJ_FORCE(a)); }
 
-#define ERR_PHYS_OBJ_T_NAN(a) { P_PHYS_OBJ_T_NAN(a); ERR_CHECK(!VEC3_NAN((a)->pos) && !VEC3_NAN((a)->scl) &&     \
-                                !VEC3_NAN((a)->rb.velocity) && !VEC3_NAN((a)->rb.force), "'%s'->idx: %d\n", #a, (a)->entity_idx); }
+#define ERR_PHYS_OBJ_T_NAN(a) { P_PHYS_OBJ_T_NAN(a); ERR_CHECK(!VEC3_NAN(PHYS_OBJ_POS(a)) && !VEC3_NAN((a)->scl) &&     \
+                                !VEC3_NAN(PHYS_OBJ_VELOCITY(a)) && !VEC3_NAN(PHYS_OBJ_FORCE(a)), "'%s'->idx: %d\n", #a, (a)->entity_idx); }
 
 // @NOTE: mistook mynkowski sum for addition sum, lol
 // // INLINE void phys_aabb_add(box_collider_t* b0, box_collider_t* b1, box_collider_t* out)
@@ -205,18 +258,31 @@ typedef struct phys_obj_t
 //   out[1][1] = b0[1][1] + b1[1][2];
 //   out[1][2] = b0[1][2] + b1[1][3];
 // }
-INLINE void phys_get_final_aabb(phys_obj_t* b, vec3* out)
+// @DOC: cache collider bounds relative to pos + offset, see collider_t.bounds
+//       gets called when adding / refreshing objs
+//       call phys_broadphase_refresh() after changing scl, offset or collider size of an obj directly
+INLINE void phys_obj_update_bounds(phys_obj_t* obj)
 {
-  f32* min = (f32*)&out[0];
-  f32* max = (f32*)&out[1];
-  vec3_copy(b->collider.box.aabb[0], min);
-  vec3_copy(b->collider.box.aabb[1], max);
-  vec3_mul(min, b->scl, min);
-  vec3_mul(max, b->scl, max);
-	vec3_add(min, b->pos, min);
-	vec3_add(max, b->pos, max);
-	vec3_add(min, b->collider.offset, min);
-	vec3_add(max, b->collider.offset, max);
+  vec3* b = obj->collider.bounds;
+  if (!PHYS_OBJ_HAS_COLLIDER(obj))
+  {
+    vec3_copy(VEC3(0), b[0]);
+    vec3_copy(VEC3(0), b[1]);
+    obj->collider.bounds_radius = 0.0f;
+  }
+  else if (obj->collider.type == PHYS_COLLIDER_BOX)
+  {
+    vec3_mul(obj->collider.box.aabb[0], obj->scl, b[0]);
+    vec3_mul(obj->collider.box.aabb[1], obj->scl, b[1]);
+    obj->collider.bounds_radius = 0.0f;
+  }
+  else
+  {
+    f32 radius = obj->collider.sphere.radius * ((obj->scl[0] + obj->scl[1] + obj->scl[2]) * 0.33f);
+    vec3_copy(VEC3(-radius), b[0]);
+    vec3_copy(VEC3(radius), b[1]);
+    obj->collider.bounds_radius = radius;
+  }
 }
 
 // --- raycasting ---
@@ -226,8 +292,9 @@ typedef struct
   vec3 pos;
   vec3 dir;
   f32  len; // <= 0.0f, means length is ignored
-  int* mask_arr;
+  int* mask_arr;         // entity id's to ignore
   int  mask_arr_len;
+  u32  exclude_layers;   // layers to ignore, bit per layer, see PHYS_LAYER_BIT(), 0 hits all
 
   bool draw_debug;
 
@@ -238,6 +305,7 @@ typedef struct
   .dir = { 0.0f, 0.0f, 0.0f },    \
   .len = -1.0f,                   \
   .mask_arr = NULL,               \
+  .exclude_layers = 0,            \
   .draw_debug = false,            \
 }
 #define RAY_T_INIT(_pos, _dir, _len, _mask_arr, _mask_arr_len)  \
@@ -247,6 +315,7 @@ typedef struct
   .len = (_len),                                                \
   .mask_arr     = _mask_arr,                                    \
   .mask_arr_len = _mask_arr_len,                                \
+  .exclude_layers = 0,                                          \
   .draw_debug = false,                                          \
 }
 #define RAY_T_INIT_MASK(_pos, _dir, _mask_arr, _mask_arr_len)   \
@@ -256,6 +325,7 @@ typedef struct
   .len = -1.0f,                                                 \
   .mask_arr     = _mask_arr,                                    \
   .mask_arr_len = _mask_arr_len,                                \
+  .exclude_layers = 0,                                          \
   .draw_debug = false,                                          \
 }
 #define RAY_T_INIT_LEN(_pos, _dir, _len)      \
@@ -265,6 +335,7 @@ typedef struct
   .len = (_len),                              \
   .mask_arr = NULL,                           \
   .mask_arr_len = 0,                          \
+  .exclude_layers = 0,                        \
   .draw_debug = false,                        \
 }
 #define RAY_T_INIT_SIMPLE(_pos, _dir)         \
@@ -274,6 +345,7 @@ typedef struct
   .len = -1.0f,                               \
   .mask_arr = NULL,                           \
   .mask_arr_len = 0,                          \
+  .exclude_layers = 0,                        \
   .draw_debug = false,                        \
 }
 
@@ -3,6 +3,12 @@
 #include "phys/phys_dynamics.h"
 #include "phys/phys_resolution.h"
 #include "phys/phys_collision.h"
+#include "phys/phys_broadphase.h"
+#include "phys/phys_island.h"
+#include "phys/phys_threads.h"
+#include "phys/phys_bodies.h"
+#include "phys/phys_arena.h"
+#include "phys/phys_hash.h"
 #include "phys/phys_debug_draw.h"
 #include "core/debug/debug_draw.h"
 #include "phys/phys_types.h"
@@ -15,8 +21,65 @@
 
 
 // all objects, static and dynamic
+// static objs first, then all objs with rigidbody
+// [0, phys_objs_static_len) static, [phys_objs_static_len, phys_objs_len) rigidbodies
 phys_obj_t* phys_objs = NULL;
 u32 phys_objs_len = 0;
+u32 phys_objs_static_len = 0;
+
+// slot map, handles point to a slot, the slot to the obj in phys_objs
+// removed objs put their slot in the free list, see phys_handle_t
+typedef struct
+{
+  u32 obj_idx;    // idx into phys_objs, if in use
+  u32 gen;        // bumped every time the slot gets freed
+  int next_free;  // next free slot, -1 if last, only if not in use
+  int next_entity;// next slot with the same entity_idx, -1 if last, see phys_entity_map
+}phys_slot_t;
+phys_slot_t* phys_slots     = NULL;
+u32          phys_slots_len = 0;
+int          phys_slots_free = -1;  // first free slot, -1 if none
+
+// entity_idx -> first slot of the objs attached to it, stb_ds hashmap
+// more objs with the same entity_idx get chained with phys_slot_t.next_entity
+struct { int key; int value; }* phys_entity_map = NULL;
+
+// pos, velocity, etc. of all objs, same idx as phys_objs, see PHYS_OBJ_POS()
+phys_bodies_t phys_bodies = PHYS_BODIES_T_INIT();
+
+// scratch memory for one step or query, reset at the start of phys_update()
+phys_arena_t phys_frame_arena = PHYS_ARENA_T_INIT();
+u32          phys_step_allocs = 0;  // phys_alloc_count increase in last phys_update()
+
+// fixed steps, see phys_settings_t.fixed_dt
+f32 phys_fixed_dt     = 0.0f;   // 0 steps with the dt passed to phys_update()
+u32 phys_max_substeps = 4;
+f32 phys_accumulator  = 0.0f;   // time not stepped yet, < phys_fixed_dt after phys_update()
+f32 phys_interp_alpha = 1.0f;   // phys_accumulator / phys_fixed_dt, see phys_get_interp_alpha()
+u32 phys_substep      = 0;      // step in the current phys_update(), contact events only get cleared on the first
+u32 phys_substeps     = 0;      // steps done in the last phys_update()
+
+// contact events of the last phys_update(), see phys_get_contact_events()
+phys_contact_event_t* phys_contact_event_arr      = NULL; // stb_ds arr, its length is the capacity
+u32                   phys_contact_event_arr_len  = 0;
+u32                   phys_contact_events_dropped = 0;
+
+// contacts of reporting objs seen in earlier steps, to tell begin / stay / end apart
+// phys_touching_map has the idx into phys_touching_arr for both slot idx's, lower one in the upper 32 bits
+// slots get reused, so an entry only belongs to the objs if the handles gen's match too
+typedef struct
+{
+  u64 key;
+  phys_handle_t obj0;
+  phys_handle_t obj1;
+  int entity0;
+  int entity1;
+  u32 stamp;      // last step the contact was seen in
+}phys_touching_t;
+phys_touching_t* phys_touching_arr     = NULL;  // stb_ds arr, removing moves the last one into its place
+u32              phys_touching_arr_len = 0;
+phys_hash_t      phys_touching_map     = PHYS_HASH_T_INIT();
+u32              phys_touching_stamp   = 0;   // incremented every step
 
 // callbacks, macros to check for null
 phys_internal_collision_callback* phys_collision_callback = NULL;
@@ -24,9 +87,48 @@ phys_internal_trigger_callback*   phys_trigger_callback   = NULL;
 #define COLLISION_CALLBACK(a, b)  if (phys_collision_callback) { phys_collision_callback((a), (b)); }
 #define TRIGGER_CALLBACK(a, b)    if (phys_trigger_callback)   { phys_trigger_callback((a), (b)); }
 
+// sleeping, see phys_settings_t
+bool phys_sleep_enabled   = true;
+f32  phys_sleep_velocity  = 0.1f;
+f32  phys_sleep_time      = 0.5f;
+u32  phys_sleep_island_id = 0;    // last id given to an island falling asleep
+
+// items per phys_threads_run() job
+#define PHYS_DYNAMICS_CHUNK     256
+#define PHYS_NARROWPHASE_CHUNK  64
+#define PHYS_ISLANDS_CHUNK      8
+
+// added to how far both objs moved, see phys_update_new_near()
+#define PHYS_CONTACT_MARGIN  0.01f
+
+// contact found while stepping an island, gets applied in phys_update_new_flush()
+typedef struct
+{
+  int obj0;           // idx into phys_objs, has rigidbody
+  int obj1;           // idx into phys_objs
+  collision_info_t c;
+}phys_step_contact_t;
+
+// output of stepping one island, each island only touches its own rigidbodies
+// so any thread can step it, writes to static objs get put in contacts
+typedef struct
+{
+  u32 pairs_start;                // idx into phys_step_pair_arr
+  u32 pairs_len;
+  phys_step_contact_t* contacts;  // at most one per pair, pairs_len long, in phys_frame_arena
+  u32 contacts_len;
+}phys_step_island_t;
+
+// all in phys_frame_arena, only valid during phys_update_new()
+phys_step_island_t* phys_step_island_arr = NULL;  
+u32*                phys_step_pair_arr   = NULL;  // idx's into the broadphase pairs, sorted by island
+
+// narrowphase result per broadphase pair, 1 if touching, each thread writes its own chunks
+// touching ones get collected in pair order into phys_contact_pair_arr
+u8*  phys_narrow_touching_arr  = NULL;
+u32* phys_contact_pair_arr     = NULL;
+u32  phys_contact_pair_arr_len = 0;
 
-phys_obj_combination_t* combination_arr = NULL;
-u32                     combination_arr_len = 0;
 
 // @TODO: move below update()
 
@@ -37,8 +139,7 @@ void phys_obj_make_rb(f32 mass, f32 friction, phys_obj_t* obj)
   // obj->rb.drag = drag;       // gets set in RIGIDBODY_T_INIT()
   // obj->rb.friction = 0.2f;   // gets set in RIGIDBODY_T_INIT()
   obj->rb.friction = friction;   
-  vec3_copy(VEC3(0), obj->rb.velocity);
-  vec3_copy(VEC3(0), obj->rb.force);
+  // velocity and force get zeroed when adding, see phys_bodies_init()
 }
 void phys_obj_make_box(vec3 aabb[2], vec3 offset, bool is_trigger, phys_obj_t* obj)
 {
@@ -55,8 +156,7 @@ void phys_obj_make_box(vec3 aabb[2], vec3 offset, bool is_trigger, phys_obj_t* o
   vec3_copy(aabb[0], obj->collider.box.aabb[0]);
   vec3_copy(aabb[1], obj->collider.box.aabb[1]);
 
-  obj->collider.infos = NULL;
-  obj->collider.infos_len = 0;
+  phys_obj_update_bounds(obj);
 }
 void phys_obj_make_sphere(f32 radius, vec3 offset, bool is_trigger, phys_obj_t* obj)
 {
@@ -72,103 +172,402 @@ void phys_obj_make_sphere(f32 radius, vec3 offset, bool is_trigger, phys_obj_t*
   
   obj->collider.sphere.radius = radius;
 
-  obj->collider.infos = NULL;
-  obj->collider.infos_len = 0;
+  phys_obj_update_bounds(obj);
+}
+
+// move obj in phys_objs, overwrites whatever is at to
+static void phys_move_obj(u32 from, u32 to)
+{
+  if (from == to) { return; }
+  phys_objs[to] = phys_objs[from];
+  phys_bodies_move(&phys_bodies, from, to);
+  phys_broadphase_set_obj_idx(&phys_objs[to], (int)to);
+  phys_slots[phys_objs[to].slot_idx].obj_idx = to;
+}
+
+// get slot for obj, reuses freed ones, obj_idx still has to be set
+static phys_slot_t* phys_alloc_slot(phys_obj_t* obj)
+{
+  int slot_idx = phys_slots_free;
+  if (slot_idx >= 0)
+  { phys_slots_free = phys_slots[slot_idx].next_free; }
+  else
+  {
+    phys_slot_t s = { .obj_idx = 0, .gen = 1, .next_free = -1, .next_entity = -1 };
+    arrput(phys_slots, s);
+    slot_idx = (int)phys_slots_len++;
+  }
+  phys_slot_t* slot = &phys_slots[slot_idx];
+  slot->next_free = -1;
+  obj->slot_idx   = (u32)slot_idx;
+
+  // put in front of the entities chain
+  ptrdiff_t e = hmgeti(phys_entity_map, obj->entity_idx);
+  slot->next_entity = e >= 0 ? phys_entity_map[e].value : -1;
+  hmput(phys_entity_map, obj->entity_idx, slot_idx);
+
+  return slot;
 }
 
-void phys_add_obj_rb(int entity_idx, vec3 pos, f32 mass, f32 friction)
+// add to phys_objs and broadphase, keeps static objs in front of rigidbodies
+static phys_handle_t phys_add_obj(phys_obj_t* obj, vec3 pos)
+{
+  phys_obj_update_bounds(obj);  // scl might have been set after the collider
+  phys_slot_t* slot = phys_alloc_slot(obj);
+  int slot_idx = (int)obj->slot_idx;
+
+  arrput(phys_objs, *obj);
+  u32 idx = phys_objs_len++;
+  phys_bodies_resize(&phys_bodies, phys_objs_len);
+  if (!PHYS_OBJ_HAS_RIGIDBODY(obj))
+  {
+    // swap with first rigidbody
+    if (idx != phys_objs_static_len)
+    {
+      phys_move_obj(phys_objs_static_len, idx);
+      phys_objs[phys_objs_static_len] = *obj;
+      idx = phys_objs_static_len;
+    }
+    phys_objs_static_len++;
+  }
+  phys_bodies_init(&phys_bodies, idx, pos);
+  slot->obj_idx = idx;
+  phys_broadphase_add(&phys_objs[idx], (int)idx);
+
+  phys_handle_t h = { .idx = (u32)slot_idx, .gen = slot->gen };
+  return h;
+}
+
+phys_handle_t phys_add_obj_rb(int entity_idx, vec3 pos, f32 mass, f32 friction)
 {
   phys_obj_t obj = PHYS_OBJ_T_INIT();
   obj.entity_idx = entity_idx;
-  vec3_copy(pos, obj.pos);
-  vec3_copy(pos, obj.last_pos);
   vec3_copy(VEC3(1), obj.scl);
 
   phys_obj_make_rb(mass, friction, &obj);
 
-  arrput(phys_objs, obj);
-  phys_objs_len++;
-  phys_generate_combinations(); // re-generate combinations after add
+  return phys_add_obj(&obj, pos);
 }
-void phys_add_obj_box(int entity_idx, vec3 pos, vec3 scl, vec3 aabb[2], vec3 offset, bool is_trigger)
+phys_handle_t phys_add_obj_box(int entity_idx, vec3 pos, vec3 scl, vec3 aabb[2], vec3 offset, bool is_trigger)
 {
   phys_obj_t obj = PHYS_OBJ_T_INIT();
   obj.entity_idx = entity_idx;
-  vec3_copy(pos, obj.pos);
-  vec3_copy(pos, obj.last_pos);
   vec3_copy(scl, obj.scl);
 
   phys_obj_make_box(aabb, offset, is_trigger, &obj); 
 
-  arrput(phys_objs, obj);
-  phys_objs_len++;
-  phys_generate_combinations(); // re-generate combinations after add
+  return phys_add_obj(&obj, pos);
 }
-void phys_add_obj_sphere(int entity_idx, vec3 pos, vec3 scl, f32 radius, vec3 offset, bool is_trigger)
+phys_handle_t phys_add_obj_sphere(int entity_idx, vec3 pos, vec3 scl, f32 radius, vec3 offset, bool is_trigger)
 {
   phys_obj_t obj = PHYS_OBJ_T_INIT();
   obj.entity_idx = entity_idx;
-  vec3_copy(pos, obj.pos);
-  vec3_copy(pos, obj.last_pos);
   vec3_copy(scl, obj.scl);
 
   phys_obj_make_sphere(radius, offset, is_trigger, &obj); 
 
-  arrput(phys_objs, obj);
-  phys_objs_len++;
-  phys_generate_combinations(); // re-generate combinations after add
+  return phys_add_obj(&obj, pos);
 }
-void phys_add_obj_rb_box(int entity_idx, vec3 pos, vec3 scl, f32 mass, f32 friction, vec3 aabb[2], vec3 offset, bool is_trigger)
+phys_handle_t phys_add_obj_rb_box(int entity_idx, vec3 pos, vec3 scl, f32 mass, f32 friction, vec3 aabb[2], vec3 offset, bool is_trigger)
 {
   phys_obj_t obj = PHYS_OBJ_T_INIT();
   obj.entity_idx = entity_idx;
-  vec3_copy(pos, obj.pos);
-  vec3_copy(pos, obj.last_pos);
   vec3_copy(scl, obj.scl);
 
   phys_obj_make_rb(mass, friction, &obj);
   phys_obj_make_box(aabb, offset, is_trigger, &obj);
 
-  arrput(phys_objs, obj);
-  phys_objs_len++;
-  phys_generate_combinations(); // re-generate combinations after add
+  return phys_add_obj(&obj, pos);
 }
-void phys_add_obj_rb_sphere(int entity_idx, vec3 pos, vec3 scl, f32 mass, f32 friction, f32 radius, vec3 offset, bool is_trigger)
+phys_handle_t phys_add_obj_rb_sphere(int entity_idx, vec3 pos, vec3 scl, f32 mass, f32 friction, f32 radius, vec3 offset, bool is_trigger)
 {
   phys_obj_t obj = PHYS_OBJ_T_INIT();
   obj.entity_idx = entity_idx;
-  vec3_copy(pos, obj.pos);
-  vec3_copy(pos, obj.last_pos);
   vec3_copy(scl, obj.scl);
 
   phys_obj_make_rb(mass, friction, &obj);
   phys_obj_make_sphere(radius, offset, is_trigger, &obj);
 
-  arrput(phys_objs, obj);
-  phys_objs_len++;
-  phys_generate_combinations(); // re-generate combinations after add
+  return phys_add_obj(&obj, pos);
 }
 
-// @UNSURE: 
-void phys_remove_obj(int entity_idx)
+void phys_add_objs(phys_obj_desc_t* descs, u32 descs_len, phys_handle_t* handles_out)
 {
-  for (int i = 0; i < (int)phys_objs_len; ++i)
+  if (descs_len == 0) { return; }
+
+  // reserve once
+  u32 old_len    = phys_objs_len;
+  u32 static_len = phys_objs_static_len;
+  u32 rbs_len    = old_len - static_len;
+  arrsetcap(phys_objs, old_len + descs_len);
+  arrsetcap(phys_slots, phys_slots_len + descs_len);
+
+  u32 new_static_len = 0;
+  for (u32 i = 0; i < descs_len; ++i)
   {
-    if (phys_objs[i].entity_idx == entity_idx) 
-    { 
-      arrdel(phys_objs, (u32)i); 
-      phys_objs_len--;
+    if (!HAS_FLAG(descs[i].flags, PHYS_HAS_RIGIDBODY)) { new_static_len++; }
+  }
+
+  // make room for the new statics, first rigidbodies go behind the others
+  arrsetlen(phys_objs, old_len + descs_len);
+  phys_objs_len = old_len + descs_len;
+  phys_bodies_resize(&phys_bodies, phys_objs_len);
+  u32 moved = MIN(new_static_len, rbs_len);
+  for (u32 i = 0; i < moved; ++i)
+  { phys_move_obj(static_len + i, static_len + MAX(new_static_len, rbs_len) + i); }
+
+  u32 static_idx = static_len;
+  u32 rb_idx     = static_len + new_static_len + rbs_len;
+  for (u32 i = 0; i < descs_len; ++i)
+  {
+    phys_obj_desc_t* d = &descs[i];
+    ASSERT(d->layer < PHYS_LAYERS_MAX);
+    ASSERT(!HAS_FLAG(d->flags, PHYS_HAS_BOX) || !HAS_FLAG(d->flags, PHYS_HAS_SPHERE));
+    phys_obj_t obj = PHYS_OBJ_T_INIT();
+    obj.entity_idx = d->entity_idx;
+    vec3_copy(d->scl, obj.scl);
+    obj.flags |= d->flags & PHYS_REPORT_CONTACTS;
+    obj.layer      = d->layer;
+    obj.layer_mask = d->layer_mask;
+    if (HAS_FLAG(d->flags, PHYS_HAS_RIGIDBODY)) { phys_obj_make_rb(d->mass, d->friction, &obj); }
+    if      (HAS_FLAG(d->flags, PHYS_HAS_BOX))    { phys_obj_make_box(d->aabb, d->offset, d->is_trigger, &obj); }
+    else if (HAS_FLAG(d->flags, PHYS_HAS_SPHERE)) { phys_obj_make_sphere(d->radius, d->offset, d->is_trigger, &obj); }
+
+    phys_slot_t* slot = phys_alloc_slot(&obj);
+    u32 idx = PHYS_OBJ_HAS_RIGIDBODY(&obj) ? rb_idx++ : static_idx++;
+    slot->obj_idx = idx;
+    phys_objs[idx] = obj;
+    phys_bodies_init(&phys_bodies, idx, d->pos);
+    if (handles_out)
+    {
+      handles_out[i].idx = obj.slot_idx;
+      handles_out[i].gen = slot->gen;
     }
   }
-  phys_generate_combinations(); // re-generate combinations after remove 
+  phys_objs_static_len = static_len + new_static_len;
+
+  // statics only mark the static structure dirty, gets built once on the next update
+  phys_broadphase_add_arr(phys_objs, static_len, static_len + new_static_len);
+  phys_broadphase_add_arr(phys_objs, static_len + new_static_len + rbs_len, phys_objs_len);
+}
+
+// wake obj and every obj that fell asleep together with it
+static void phys_wake_island(phys_obj_t* obj)
+{
+  if (!PHYS_OBJ_HAS_RIGIDBODY(obj) || !obj->rb.is_sleeping) { return; }
+  // walk the islands ring, slots stay the same while the objs move around in phys_objs
+  u32 island = obj->rb.sleep_island;
+  phys_obj_t* o = obj;
+  while (o->rb.is_sleeping && o->rb.sleep_island == island)
+  {
+    o->rb.is_sleeping = false;
+    o->rb.sleep_time  = 0.0f;
+    o = &phys_objs[phys_slots[o->rb.sleep_next].obj_idx];
+  }
+}
+static bool phys_wake_around_callback(int obj_idx, void* data)
+{
+  (void)data;
+  phys_wake_island(&phys_objs[obj_idx]);
+  return true;
+}
+// wake all objs touching obj, i.e. before removing or changing it
+static void phys_wake_around(phys_obj_t* obj)
+{
+  phys_wake_island(obj);
+  if (!PHYS_OBJ_HAS_COLLIDER(obj)) { return; }
+  vec3 min, max;
+  phys_broadphase_obj_aabb(obj, min, max);
+  vec3_sub_f(min, PHYS_BVH_AABB_MARGIN, min);
+  vec3_add_f(max, PHYS_BVH_AABB_MARGIN, max);
+  phys_broadphase_query_aabb(min, max, phys_wake_around_callback, NULL);
+}
+
+// first slot of the objs attached to entity_idx, -1 if none
+static int phys_entity_first_slot(int entity_idx)
+{
+  ptrdiff_t e = hmgeti(phys_entity_map, entity_idx);
+  return e >= 0 ? phys_entity_map[e].value : -1;
+}
+// loop over all objs attached to entity_idx, obj gets set to each
+#define PHYS_FOR_ENTITY_OBJS(entity_idx, obj)                                                   \
+  for (int _slot = phys_entity_first_slot(entity_idx);                                         \
+       _slot >= 0 && ((obj) = &phys_objs[phys_slots[_slot].obj_idx], true);                   \
+       _slot = phys_slots[_slot].next_entity)
+
+void phys_wake(int entity_idx)
+{
+  phys_obj_t* obj;
+  PHYS_FOR_ENTITY_OBJS(entity_idx, obj)
+  { phys_wake_island(obj); }
+}
+void phys_add_force(int entity_idx, vec3 force)
+{
+  phys_obj_t* obj;
+  PHYS_FOR_ENTITY_OBJS(entity_idx, obj)
+  {
+    if (!PHYS_OBJ_HAS_RIGIDBODY(obj)) { continue; }
+    phys_wake_island(obj);
+    vec3_add(PHYS_OBJ_FORCE(obj), force, PHYS_OBJ_FORCE(obj));
+  }
+}
+
+phys_obj_t* phys_get_obj_entity(int entity_idx)
+{
+  int slot = phys_entity_first_slot(entity_idx);
+  return slot >= 0 ? &phys_objs[phys_slots[slot].obj_idx] : NULL;
+}
+bool phys_get_pos(int entity_idx, vec3 out)
+{
+  phys_obj_t* obj = phys_get_obj_entity(entity_idx);
+  if (!obj) { return false; }
+  vec3_copy(PHYS_OBJ_POS(obj), out);
+  return true;
+}
+bool phys_get_interp_pos(int entity_idx, vec3 out)
+{
+  phys_obj_t* obj = phys_get_obj_entity(entity_idx);
+  if (!obj) { return false; }
+  if (!PHYS_OBJ_HAS_RIGIDBODY(obj)) 
+  { 
+    vec3_copy(PHYS_OBJ_POS(obj), out);
+    return true;
+  }
+  for (int a = 0; a < 3; ++a)
+  { out[a] = PHYS_OBJ_LAST_POS(obj)[a] + (PHYS_OBJ_POS(obj)[a] - PHYS_OBJ_LAST_POS(obj)[a]) * phys_interp_alpha; }
+  return true;
+}
+void phys_set_pos(int entity_idx, vec3 pos)
+{
+  phys_obj_t* obj;
+  PHYS_FOR_ENTITY_OBJS(entity_idx, obj)
+  {
+    phys_wake_around(obj);  // objs resting on it
+    vec3_copy(pos, PHYS_OBJ_POS(obj));
+    vec3_copy(pos, PHYS_OBJ_LAST_POS(obj));  // teleport, not a move the swept checks should see
+    phys_broadphase_refresh(obj);  // queries before the next update see the new pos
+    phys_wake_around(obj);  // objs at the new pos
+  }
+}
+bool phys_get_velocity(int entity_idx, vec3 out)
+{
+  phys_obj_t* obj;
+  PHYS_FOR_ENTITY_OBJS(entity_idx, obj)
+  {
+    if (!PHYS_OBJ_HAS_RIGIDBODY(obj)) { continue; }
+    vec3_copy(PHYS_OBJ_VELOCITY(obj), out);
+    return true;
+  }
+  return false;
+}
+void phys_set_velocity(int entity_idx, vec3 velocity)
+{
+  phys_obj_t* obj;
+  PHYS_FOR_ENTITY_OBJS(entity_idx, obj)
+  {
+    if (!PHYS_OBJ_HAS_RIGIDBODY(obj)) { continue; }
+    phys_wake_island(obj);
+    vec3_copy(velocity, PHYS_OBJ_VELOCITY(obj));
+  }
+}
+bool phys_get_force(int entity_idx, vec3 out)
+{
+  phys_obj_t* obj;
+  PHYS_FOR_ENTITY_OBJS(entity_idx, obj)
+  {
+    if (!PHYS_OBJ_HAS_RIGIDBODY(obj)) { continue; }
+    vec3_copy(PHYS_OBJ_FORCE(obj), out);
+    return true;
+  }
+  return false;
+}
+void phys_set_force(int entity_idx, vec3 force)
+{
+  phys_obj_t* obj;
+  PHYS_FOR_ENTITY_OBJS(entity_idx, obj)
+  {
+    if (!PHYS_OBJ_HAS_RIGIDBODY(obj)) { continue; }
+    phys_wake_island(obj);
+    vec3_copy(force, PHYS_OBJ_FORCE(obj));
+  }
+}
+
+// remove obj at idx in phys_objs, fills the hole with the last obj instead of shifting
+static void phys_remove_obj_idx(u32 idx)
+{
+  phys_obj_t* obj = &phys_objs[idx];
+  phys_wake_around(obj); // might have been holding sleeping objs
+  phys_broadphase_remove(obj);
+
+  // unlink from the entities chain
+  int slot_idx = (int)obj->slot_idx;
+  phys_slot_t* slot = &phys_slots[slot_idx];
+  int first = phys_entity_first_slot(obj->entity_idx);
+  if (first == slot_idx)
+  {
+    if (slot->next_entity >= 0) { hmput(phys_entity_map, obj->entity_idx, slot->next_entity); }
+    else                        { hmdel(phys_entity_map, obj->entity_idx); }
+  }
+  else
+  {
+    int prev = first;
+    while (phys_slots[prev].next_entity != slot_idx) { prev = phys_slots[prev].next_entity; }
+    phys_slots[prev].next_entity = slot->next_entity;
+  }
+  slot->next_entity = -1;
+
+  slot->gen++;
+  slot->next_free = phys_slots_free;
+  phys_slots_free = (int)obj->slot_idx;
+
+  u32 last = phys_objs_len -1;
+  if (idx < phys_objs_static_len)
+  {
+    // last static fills the hole, last rigidbody fills the hole left by the last static
+    u32 last_static = phys_objs_static_len -1;
+    phys_move_obj(last_static, idx);
+    phys_move_obj(last, last_static);
+    phys_objs_static_len--;
+  }
+  else
+  { phys_move_obj(last, idx); }
+  arrsetlen(phys_objs, last);
+  phys_objs_len = last;
+  phys_bodies_resize(&phys_bodies, last);
+}
+
+void phys_remove_obj(int entity_idx)
+{
+  int slot;
+  while ((slot = phys_entity_first_slot(entity_idx)) >= 0)
+  { phys_remove_obj_idx(phys_slots[slot].obj_idx); }
+}
+void phys_remove_obj_handle(phys_handle_t h)
+{
+  phys_obj_t* obj = phys_get_obj(h);
+  if (!obj) { return; }
+  phys_remove_obj_idx((u32)(obj - phys_objs));
+}
+// handle of obj thats in phys_objs
+static phys_handle_t phys_obj_handle(phys_obj_t* obj)
+{
+  phys_handle_t h = { .idx = obj->slot_idx, .gen = phys_slots[obj->slot_idx].gen };
+  return h;
+}
+phys_obj_t* phys_get_obj(phys_handle_t h)
+{
+  if (h.idx >= phys_slots_len) { return NULL; }
+  phys_slot_t* slot = &phys_slots[h.idx];
+  if (slot->gen != h.gen) { return NULL; }  // removed, freeing bumps gen
+  return &phys_objs[slot->obj_idx];
 }
 
 void phys_rotate_box_y(int entity_idx)
 {
-  for (u32 i = 0; i < phys_objs_len; ++i)
+  phys_obj_t* obj;
+  PHYS_FOR_ENTITY_OBJS(entity_idx, obj)
   {
-    phys_obj_t* obj = &phys_objs[i];
-    if (obj->entity_idx == entity_idx && PHYS_OBJ_HAS_COLLIDER(obj) && obj->collider.type == PHYS_COLLIDER_BOX) 
+    if (PHYS_OBJ_HAS_COLLIDER(obj) && obj->collider.type == PHYS_COLLIDER_BOX) 
     {
       // switch x / z
       vec3 min, max;
@@ -180,8 +579,11 @@ void phys_rotate_box_y(int entity_idx)
       max[1] = obj->collider.box.aabb[1][1];
       max[2] = obj->collider.box.aabb[1][0];
 
+      phys_wake_around(obj);
       vec3_copy(min, obj->collider.box.aabb[0]);
       vec3_copy(max, obj->collider.box.aabb[1]);
+      phys_broadphase_refresh(obj);
+      phys_wake_around(obj);
     }
   }
 }
@@ -191,6 +593,31 @@ void phys_clear_state()
 {
   ARRFREE(phys_objs);
   phys_objs_len = 0;
+  phys_objs_static_len = 0;
+  ARRFREE(phys_slots);
+  phys_slots_len  = 0;
+  phys_slots_free = -1;
+  hmfree(phys_entity_map);
+  ARRFREE(phys_touching_arr);
+  phys_touching_arr_len = 0;
+  phys_hash_clear(&phys_touching_map);
+  phys_touching_stamp = 0;
+  phys_contact_event_arr_len  = 0;
+  phys_contact_events_dropped = 0;
+  phys_accumulator  = 0.0f;
+  phys_interp_alpha = 1.0f;
+  phys_substep      = 0;
+  phys_substeps     = 0;
+  phys_sleep_island_id = 0;
+  phys_broadphase_clear();
+  phys_island_clear();
+  phys_bodies_clear(&phys_bodies);
+  phys_arena_free(&phys_frame_arena);
+  phys_step_island_arr      = NULL;
+  phys_step_pair_arr        = NULL;
+  phys_narrow_touching_arr  = NULL;
+  phys_contact_pair_arr     = NULL;
+  phys_contact_pair_arr_len = 0;
 }
 
 phys_obj_t* phys_get_obj_arr(u32* len)
@@ -198,297 +625,749 @@ phys_obj_t* phys_get_obj_arr(u32* len)
   *len = phys_objs_len;
   return phys_objs;
 }
-
-// gen every combination of objs
-// so only have to check collision once per combination
-void phys_generate_combinations()
-{
-  // ARRFREE(combination_arr);
-  // combination_arr_len = 0;
-  // 
-  // // P_LINE_STR("combinations ");
-  // // P_INT(phys_objs_len);
-
-	// for (u32 a = 0; a < phys_objs_len; ++a)
-  // {
-  //   // // skip static objects
-  //   phys_obj_t* obj0 = &phys_objs[a];
-	// 	if (!PHYS_OBJ_HAS_COLLIDER(obj0)) { continue; }
-	//   
-  //   for (u32 b = a+1; b < phys_objs_len; ++b)
-  //   {
-  //     phys_obj_t* obj1 = &phys_objs[b];
-	// 	  if (!PHYS_OBJ_HAS_COLLIDER(obj1)) { continue; }
-  //     
-  //     // _PF("c[%d] a: %d, b: %d\n", combination_arr_len, a, b);
-  //     
-  //     phys_obj_combination_t c = { .a = a, .b = b };
-  //     arrput(combination_arr, c);
-  //     combination_arr_len++;
-  //   }
-  // }
+phys_obj_t* phys_get_static_obj_arr(u32* len)
+{
+  *len = phys_objs_static_len;
+  return phys_objs;
+}
+phys_obj_t* phys_get_rb_obj_arr(u32* len)
+{
+  *len = phys_objs_len - phys_objs_static_len;
+  return phys_objs + phys_objs_static_len;
+}
+phys_bodies_t* phys_get_bodies()
+{
+  return &phys_bodies;
+}
+phys_arena_t* phys_get_frame_arena()
+{
+  return &phys_frame_arena;
+}
+void phys_get_alloc_stats(phys_alloc_stats_t* out)
+{
+  out->step_allocs  = phys_step_allocs;
+  out->total_allocs = phys_alloc_count;
+  out->arena_size   = (u32)arrlenu(phys_frame_arena.mem);
+  out->arena_peak   = phys_frame_arena.peak;
 }
 
 void phys_init(phys_internal_collision_callback* _collision_callback, phys_internal_trigger_callback* _trigger_callback)
+{
+  phys_init_settings(_collision_callback, _trigger_callback, NULL);
+}
+void phys_init_settings(phys_internal_collision_callback* _collision_callback, phys_internal_trigger_callback* _trigger_callback, phys_settings_t* settings)
 {
   phys_collision_callback = _collision_callback;
   phys_trigger_callback   = _trigger_callback;
+
+  phys_settings_t default_settings = PHYS_SETTINGS_T_INIT();
+  if (!settings) { settings = &default_settings; }
+  phys_broadphase_set_type(settings->broadphase);
+  phys_broadphase_set_grid_cell_size(settings->grid_cell_size);
+  phys_broadphase_set_static_type(settings->static_type);
+  phys_broadphase_set_octree_params(settings->octree_max_depth, settings->octree_leaf_capacity);
+  phys_sleep_enabled  = settings->sleep;
+  phys_sleep_velocity = settings->sleep_velocity;
+  phys_sleep_time     = settings->sleep_time;
+  phys_threads_init(settings->threads);
+  phys_dynamics_set_strict(settings->strict_math);
+  PHYS_ARRSETLEN(phys_contact_event_arr, settings->contact_events_max);
+  phys_contact_event_arr_len = 0;
+  phys_set_fixed_timestep(settings->fixed_dt, settings->max_substeps);
 }
 
-void phys_update(f32 dt)
+void phys_set_layer(int entity_idx, u32 layer)
 {
-  // @NOTE: tried only doing every combination
-  //        but, everything vibrating
-  //        bc. objects ontop of one another 
-  //        push into ground even though already 
-  //        collidding with ground
-  //
-  // phys_update_new(dt);
+  ASSERT(layer < PHYS_LAYERS_MAX);
+  phys_obj_t* obj;
+  PHYS_FOR_ENTITY_OBJS(entity_idx, obj)
+  { 
+    obj->layer = layer; 
+    phys_broadphase_set_layers(obj);
+  }
+}
+void phys_set_layer_mask(int entity_idx, u32 mask)
+{
+  phys_obj_t* obj;
+  PHYS_FOR_ENTITY_OBJS(entity_idx, obj)
+  { 
+    obj->layer_mask = mask; 
+    phys_broadphase_set_layers(obj);
+  }
+}
+void phys_set_layer_collision(u32 layer0, u32 layer1, bool collide)
+{
+  phys_broadphase_set_layer_collision(layer0, layer1, collide);
+}
+bool phys_get_layer_collision(u32 layer0, u32 layer1)
+{
+  return phys_broadphase_get_layer_collision(layer0, layer1);
+}
+void phys_set_report_contacts(int entity_idx, bool report)
+{
+  phys_obj_t* obj;
+  PHYS_FOR_ENTITY_OBJS(entity_idx, obj)
+  {
+    if (report) { obj->flags |=  PHYS_REPORT_CONTACTS; }
+    else        { obj->flags &= ~PHYS_REPORT_CONTACTS; }
+  }
+}
+phys_contact_event_t* phys_get_contact_events(u32* len, u32* dropped)
+{
+  *len = phys_contact_event_arr_len;
+  if (dropped) { *dropped = phys_contact_events_dropped; }
+  return phys_contact_event_arr;
+}
+
+static void phys_update_step(f32 dt)
+{
+  phys_arena_reset(&phys_frame_arena);
+
+  // @NOTE: checks every overlapping pair once
+  //        resolving both objs, see phys_collision_resolution_pair()
+  phys_update_new(dt);
 
   // @NOTE: old implementation:
   //        checks every obj against every other obj
   //        meanind does both 
   //        obj[1] v obj[2] and obj[2] v obj[1]
-  phys_update_old(dt);
+  // phys_update_old(dt);
 }
 
-void phys_update_new(f32 dt)
+void phys_update(f32 dt)
 {
-  // ---- dynamics ----
-	for (u32 i = 0; i < phys_objs_len; ++i) 
+  u32 allocs = phys_alloc_count;
+
+  if (phys_fixed_dt <= 0.0f)
   {
-    phys_obj_t* obj0 = &phys_objs[i];
-		if (!PHYS_OBJ_HAS_RIGIDBODY(obj0)) { continue; }
-    phys_dynamics_simulate(obj0, dt);
+    phys_substep = 0;
+    phys_update_step(dt);
+    phys_substeps     = 1;
+    phys_interp_alpha = 1.0f;
+    phys_step_allocs  = phys_alloc_count - allocs;
+    return;
   }
 
-  // --- collisions ---
-  phys_collision_t* collision_arr = NULL;
-  u32               collision_arr_len = 0;
-  // go through all combinations 
-  // skip objects that are static or not colliders
-	for (u32 i = 0; i < combination_arr_len; ++i) 
-	{
-    phys_obj_combination_t* combination = &combination_arr[i];
-    phys_obj_t* a = &phys_objs[combination->a];
-    phys_obj_t* b = &phys_objs[combination->b];
-    phys_obj_t* obj0 = PHYS_OBJ_HAS_RIGIDBODY(a) ? a : b;
-    phys_obj_t* obj1 = PHYS_OBJ_HAS_RIGIDBODY(a) ? b : a;
-    // phys_obj_t* obj0 = &phys_objs[combination->a];
-    // phys_obj_t* obj1 = &phys_objs[combination->b];
+  // same step length every time, frame spikes turn into more steps, not longer ones
+  phys_accumulator += dt;
+  for (phys_substep = 0; phys_substep < phys_max_substeps && phys_accumulator >= phys_fixed_dt; ++phys_substep)
+  {
+    phys_update_step(phys_fixed_dt);
+    phys_accumulator -= phys_fixed_dt;
+  }
+  phys_substeps = phys_substep;
+  phys_substep  = 0;
+
+  // hit max_substeps, drop whole steps so it doesnt keep falling behind
+  if (phys_accumulator >= phys_fixed_dt) { phys_accumulator = fmodf(phys_accumulator, phys_fixed_dt); }
+  phys_interp_alpha = phys_accumulator / phys_fixed_dt;
+
+  // no step, events of the last phys_update() are done
+  if (phys_substeps == 0) 
+  { 
+    phys_contact_event_arr_len  = 0;
+    phys_contact_events_dropped = 0;
+  }
+  phys_step_allocs = phys_alloc_count - allocs;
+}
+
+void phys_set_fixed_timestep(f32 fixed_dt, u32 max_substeps)
+{
+  phys_fixed_dt     = MAX(fixed_dt, 0.0f);
+  phys_max_substeps = MAX(max_substeps, 1);
+  phys_accumulator  = 0.0f;
+  phys_interp_alpha = 1.0f;
+}
+f32 phys_get_interp_alpha()
+{
+  return phys_interp_alpha;
+}
+u32 phys_get_substeps()
+{
+  return phys_substeps;
+}
+
+// put event in the buffer, gets dropped if its full
+static void phys_contact_event_push(phys_contact_event_type type, phys_handle_t obj0, phys_handle_t obj1, int entity0, int entity1, collision_info_t* c)
+{
+  if (phys_contact_event_arr_len >= (u32)arrlenu(phys_contact_event_arr)) 
+  { 
+    phys_contact_events_dropped++; 
+    return; 
+  }
+  phys_contact_event_t* e = &phys_contact_event_arr[phys_contact_event_arr_len++];
+  e->type    = type;
+  e->entity0 = entity0;
+  e->entity1 = entity1;
+  e->obj0    = obj0;
+  e->obj1    = obj1;
+  if (c) { e->c = *c; e->c.obj_idx = entity1; }
+  else   { collision_info_t none = COLLISION_INFO_T_INIT(); e->c = none; }
+}
+static void phys_contacts_begin_step()
+{
+  phys_touching_stamp++;
+  if (phys_substep > 0) { return; }  // keep the events of the earlier steps of this phys_update()
+  phys_contact_event_arr_len  = 0;
+  phys_contact_events_dropped = 0;
+}
+// the key only has the slot idx's, the gen's tell if t is still about the same objs
+static bool phys_touching_same_objs(phys_touching_t* t, phys_handle_t h0, phys_handle_t h1)
+{
+  if (t->obj0.idx != h0.idx) { phys_handle_t tmp = h0; h0 = h1; h1 = tmp; }
+  return t->obj0.gen == h0.gen && t->obj1.gen == h1.gen;
+}
+// obj0 touched obj1 this step, obj0 has a rigidbody
+static void phys_contacts_report(phys_obj_t* obj0, phys_obj_t* obj1, collision_info_t* c)
+{
+  if (!HAS_FLAG(obj0->flags, PHYS_REPORT_CONTACTS) && !HAS_FLAG(obj1->flags, PHYS_REPORT_CONTACTS)) { return; }
+
+  u64 key = ((u64)MIN(obj0->slot_idx, obj1->slot_idx) << 32) | (u64)MAX(obj0->slot_idx, obj1->slot_idx);
+  phys_handle_t h0 = phys_obj_handle(obj0);
+  phys_handle_t h1 = phys_obj_handle(obj1);
+  phys_touching_t new_t = 
+  { 
+    .key = key, .obj0 = h0, .obj1 = h1, 
+    .entity0 = obj0->entity_idx, .entity1 = obj1->entity_idx, .stamp = phys_touching_stamp 
+  };
+  u32* t_idx = phys_hash_get(&phys_touching_map, key);
+  phys_touching_t* t = t_idx ? &phys_touching_arr[*t_idx] : NULL;
+  if (t && !phys_touching_same_objs(t, h0, h1))
+  {
+    // one of the objs got removed and its slot reused, the old contact ended
+    phys_contact_event_push(PHYS_CONTACT_END, t->obj0, t->obj1, t->entity0, t->entity1, NULL);
+    *t = new_t;
+    phys_contact_event_push(PHYS_CONTACT_BEGIN, h0, h1, obj0->entity_idx, obj1->entity_idx, c);
+    return;
+  }
+  if (t)
+  {
+    if (t->stamp == phys_touching_stamp) { return; }  // phys_update_old() checks both ways
+    t->stamp = phys_touching_stamp;
+    phys_contact_event_push(PHYS_CONTACT_STAY, h0, h1, obj0->entity_idx, obj1->entity_idx, c);
+    return;
+  }
+  phys_hash_put(&phys_touching_map, key, phys_touching_arr_len);
+  PHYS_ARRPUT(phys_touching_arr, new_t);
+  phys_touching_arr_len++;
+  phys_contact_event_push(PHYS_CONTACT_BEGIN, h0, h1, obj0->entity_idx, obj1->entity_idx, c);
+}
+// contacts not seen this step ended
+// sleeping objs dont get checked, so contacts between resting objs stay without being seen
+static void phys_contacts_end_step()
+{
+  // backwards, the last one gets moved into the removed ones place
+  for (int i = (int)phys_touching_arr_len -1; i >= 0; --i)
+  {
+    phys_touching_t* t = &phys_touching_arr[i];
+    if (t->stamp == phys_touching_stamp) { continue; }
+
+    phys_obj_t* obj0 = phys_get_obj(t->obj0);
+    phys_obj_t* obj1 = phys_get_obj(t->obj1);
+    if (obj0 && obj1 && 
+        (!PHYS_OBJ_HAS_RIGIDBODY(obj0) || obj0->rb.is_sleeping) && 
+        (!PHYS_OBJ_HAS_RIGIDBODY(obj1) || obj1->rb.is_sleeping))
+    {
+      t->stamp = phys_touching_stamp;
+      continue;
+    }
+    phys_contact_event_push(PHYS_CONTACT_END, t->obj0, t->obj1, t->entity0, t->entity1, NULL);
+    phys_hash_remove(&phys_touching_map, t->key);
+    u32 last = --phys_touching_arr_len;
+    if ((u32)i != last)
+    {
+      *t = phys_touching_arr[last];
+      *phys_hash_get(&phys_touching_map, t->key) = (u32)i;
+    }
+    arrsetlen(phys_touching_arr, phys_touching_arr_len);
+  }
+}
+
+// check and resolve obj0 against obj1, obj0 needs a rigidbody
+static void phys_update_old_collide(phys_obj_t* obj0, phys_obj_t* obj1)
+{
+  // same as phys_update_new(), sleeping objs only get checked against awake rigidbodies and triggers
+  bool trigger = obj0->collider.is_trigger || obj1->collider.is_trigger;
+  if (!trigger && obj0->rb.is_sleeping && (!PHYS_OBJ_HAS_RIGIDBODY(obj1) || obj1->rb.is_sleeping)) { return; }
+
+	collision_info_t c = phys_collision_check(obj0, obj1);
+  obj0->collider.is_colliding = obj0->collider.is_colliding || c.collision;
+  obj0->collider.is_grounded  = obj0->collider.is_grounded  || c.grounded;
+  
+  // ---- collision response ----
+  if (!c.collision) { return; }
+
+  // notify objects of collision
+  c.trigger = obj0->collider.is_trigger || obj1->collider.is_trigger;
+  phys_contacts_report(obj0, obj1, &c);
+
+  if (!c.trigger) // no response on trigger collisions
+  {
+    // awake obj ran into a sleeping one
+    phys_wake_island(obj0);
+    phys_wake_island(obj1);
+    // P_INT(obj1->entity_idx);
+    phys_collision_resolution(obj0, obj1, c);
+    COLLISION_CALLBACK(obj0->entity_idx, obj1->entity_idx);
+  }
+  else
+  {
+    TRIGGER_CALLBACK(obj0->entity_idx, obj1->entity_idx);
+  }
+}
+
+#ifdef TERRAIN_ADDON
+// push obj0 out of the terrain, obj0 needs a rigidbody and box collider
+static void phys_update_old_terrain(phys_obj_t* obj0)
+{
+  // @TMP:
+  if (obj0->collider.type != PHYS_COLLIDER_BOX) { return; }
+  
+  // terrain collision
+  for (int chunk_idx = 0; chunk_idx < (int)core_data->terrain_chunks_len; ++chunk_idx) 
+  {
+
+    if (!core_data->terrain_chunks[chunk_idx].loaded || !core_data->terrain_chunks[chunk_idx].visible) { continue; }
+    terrain_chunk_t* chunk = &core_data->terrain_chunks[chunk_idx];
+
+    // get collider_position using cam_pos
+    // map cam-pos to 0.0 <-> 1.0 range inside the chunk
+    f32 x = ( PHYS_OBJ_POS(obj0)[0] + ( core_data->terrain_scl * 0.5f));
+    f32 z = ( PHYS_OBJ_POS(obj0)[2] + ( core_data->terrain_scl * 0.5f));
+    f32 col_x_len = (f32)core_data->terrain_collider_positions_x_len;
+    f32 col_z_len = (f32)core_data->terrain_collider_positions_z_len;
+    f32 x_perc = ( x / core_data->terrain_scl );
+    f32 z_perc = ( z / core_data->terrain_scl );
+    if (x_perc > 1.0f || x_perc < 0.0f || z_perc > 1.0f || z_perc < 0.0f) { continue; }
+    // PF("%.2f, %.2f\n", x_perc, z_perc);
     
-    // if obj0 doesnt have rigidbody, neither one has one
-    // so both static
-    if ( !PHYS_OBJ_HAS_RIGIDBODY(obj0) ) { continue; }
-    // _PF("obj0: %d, obj1: %d\n", obj0->entity_idx, obj1->entity_idx);
+    // 1. map 0.0<->1,0 to the positions arrays length's in both dimesnions
+    // 2. take those two numbers and turn them into idx for the one dimensional array
+    // floor(x +0.5): 1.49 -> 1.0, 1.51 -> 2.0
+    int x_idx = (int)floor( (x_perc * col_x_len) + 0.5f );
+    int z_idx = (int)floor( (z_perc * col_z_len) + 0.5f );
+    // int x_idx = (int)floor( (x_perc * col_x_len) );
+    // int z_idx = (int)floor( (z_perc * col_z_len) );
+    // int x_idx = (int)ceil( (x_perc * col_x_len) );
+    // int z_idx = (int)ceil( (z_perc * col_z_len) );
+    int idx = x_idx + (z_idx * (int)core_data->terrain_collider_positions_z_len);
+
+    int x_len = (int)core_data->terrain_collider_positions_x_len;
+    int z_len = (int)core_data->terrain_collider_positions_z_len;
+    // right / +x
+    bool right = ((idx+1) % x_len == 0);
+    idx -= right * 1;
+    // left / -x
+    bool left = (idx % x_len == 0);
+    idx += left * 1;
+    // bottom / -z
+    bool bottom = (idx < x_len);
+    idx += bottom * x_len;
+    // top  / +z
+    bool top = (idx + x_len >= x_len * z_len);
+    idx -= top * x_len;
+    
+    // pos1 = &chunk->collider_points[((u32)idx + core_data->terrain_collider_positions_x_len-1) *3];
+    // pos2 = &chunk->collider_points[((u32)idx + core_data->terrain_collider_positions_x_len) *3];
+    // pos1 = &chunk->collider_points[(idx - 1) *3];
+    // pos2 = &chunk->collider_points[((u32)idx + core_data->terrain_collider_positions_x_len-1) *3];
+    // pos1 = &chunk->collider_points[((u32)idx + core_data->terrain_collider_positions_x_len   ) *3];
+    // pos2 = &chunk->collider_points[((u32)idx + core_data->terrain_collider_positions_x_len +1) *3];
+    // pos1 = &chunk->collider_points[((u32)idx + core_data->terrain_collider_positions_x_len +1) *3];
+    // pos2 = &chunk->collider_points[((u32)idx +1) *3];
+    // pos1 = &chunk->collider_points[((u32)idx +1) *3];
+    // pos2 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len +1) *3];
+    // pos1 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len +1) *3];
+    // pos2 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len) *3];
+    // pos1 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len) *3];
+    // pos2 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len -1) *3];
+    // pos1 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len -1) *3];
+    // pos2 = &chunk->collider_points[((u32)idx - 1) *3];
     
-    // debug_draw_sphere_register(obj0->pos, 0.1f, RGB_F(1, 0, 0));
-    // debug_draw_line_register(obj0->pos, obj1->pos, RGB_F(0, 1, 0));
+    f32* p0 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len -1) *3];
+    f32* p1 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len)    *3];
+    f32* p2 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len +1) *3];
+    f32* p3 = &chunk->collider_points[((u32)idx -1) *3];
+    f32* p4 = &chunk->collider_points[           idx*3];
+    f32* p5 = &chunk->collider_points[((u32)idx +1) *3];
+    f32* p6 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len -1) *3];
+    f32* p7 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len)    *3];
+    f32* p8 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len +1) *3];
+    debug_draw_sphere(p4, 0.3f, RGB_F(0, 1, 1)); 
+    f32 dist = 0.0f;
+    if ( phys_collision_check_aabb_v_terrain_obj(obj0, p0, p1, p2, p3, p4, p5, p6, p7, p8, &dist) )
+    {
+      PHYS_OBJ_POS(obj0)[1] += dist;
+      PHYS_OBJ_VELOCITY(obj0)[1] = 0.0f;
+      PHYS_OBJ_FORCE(obj0)[1] *= -1.5f;
+    }
+  }
+}
+#endif // TERRAIN_ADDON
+
+void phys_update_old(f32 dt)
+{
+  phys_contacts_begin_step();
+
+  // ---- dynamics ----
+  // sleeping objs keep their state, like in phys_update_new()
+	for (u32 i = phys_objs_static_len; i < phys_objs_len; ++i) 
+	{
+    phys_obj_t* obj0 = &phys_objs[i];
+    if (obj0->rb.is_sleeping) { continue; }
+    phys_dynamics_simulate(obj0, dt);
 		
     if (!PHYS_OBJ_HAS_COLLIDER(obj0)) { continue; }
-    
     obj0->collider.is_colliding = false; 
 	  obj0->collider.is_grounded  = false; 	
+  }
 
-    // test with other collider
-		if (!PHYS_OBJ_HAS_COLLIDER(obj1)) { continue; }
+  // ---- broadphase ----
+  // only pairs with overlapping aabb's get checked
+  phys_broadphase_update(phys_objs, phys_objs_len, phys_objs_static_len);
+  u32 pairs_len = 0;
+  phys_obj_combination_t* pairs = phys_broadphase_get_pairs(&pairs_len);
 
-		collision_info_t c = phys_collision_check(obj0, obj1);
-    obj0->collider.is_colliding = obj0->collider.is_colliding || c.collision;
-    obj0->collider.is_grounded  = obj0->collider.is_grounded  || c.grounded;
-    
-    // ---- collision response ----
-		if (c.collision)
-		{
-			// notify objects of collision
-			c.trigger = obj0->collider.is_trigger || obj1->collider.is_trigger;
-
-			// c.obj_idx = obj1->entity_idx;
-			// arrput(obj0->collider.infos, c);
-			// obj0->collider.infos_len++;
-
-			// c.obj_idx = obj0->entity_idx;
-			// arrput(obj1->collider.infos, c);
-			// obj1->collider.infos_len++;
-
-		  if (!c.trigger) // && PHYS_OBJ_HAS_RIGIDBODY(obj0)) // no response on trigger collisions
-			{
-        // // P_INT(obj1->entity_idx);
-				// phys_collision_resolution(obj0, obj1, c);
-        // COLLISION_CALLBACK(obj0->entity_idx, obj1->entity_idx);
-        phys_collision_t collision = { .obj0 = obj0, .obj1 = obj1, .c = c };
-        arrput(collision_arr, collision);
-        collision_arr_len++;
-			}
-      else //  if (PHYS_OBJ_HAS_RIGIDBODY(obj0))
-      {
-        TRIGGER_CALLBACK(obj0->entity_idx, obj1->entity_idx);
-      }
-		}
+	// ---- collision ----
+  // checks both directions of every pair
+  // same as checking every obj against every other obj 
+	for (u32 i = 0; i < pairs_len; ++i) 
+	{
+    phys_obj_t* a = &phys_objs[pairs[i].a];
+    phys_obj_t* b = &phys_objs[pairs[i].b];
+    if (PHYS_OBJ_HAS_RIGIDBODY(a)) { phys_update_old_collide(a, b); }
+    if (PHYS_OBJ_HAS_RIGIDBODY(b)) { phys_update_old_collide(b, a); }
 	}
-   
-  // --- resolution ---
-  // for (int i = collision_arr_len -1; i >= 0; --i)
-  for (int i = 0; i < (int)collision_arr_len; ++i)
+
+  #ifdef TERRAIN_ADDON
+	for (u32 i = phys_objs_static_len; i < phys_objs_len; ++i) 
+	{
+    phys_obj_t* obj0 = &phys_objs[i];
+		if (!PHYS_OBJ_HAS_COLLIDER(obj0) || obj0->rb.is_sleeping) { continue; }
+    phys_update_old_terrain(obj0);
+  }
+  #endif // TERRAIN_ADDON
+
+  phys_broadphase_update_aabbs(phys_objs, phys_objs_len, phys_objs_static_len);
+
+  phys_contacts_end_step();
+}
+
+// put islands to sleep, whichs rigidbodies all moved slower than phys_sleep_velocity for phys_sleep_time
+static void phys_update_sleep(f32 dt)
+{
+  if (!phys_sleep_enabled || dt <= 0.0f) { return; }
+
+  // use how far it actually moved, the velocity of resting objs keeps getting gravity added
+  for (u32 i = phys_objs_static_len; i < phys_objs_len; ++i) 
   {
-    phys_collision_t* collision = &collision_arr[i];
-		phys_collision_resolution(collision->obj0, collision->obj1, collision->c);
-    COLLISION_CALLBACK(collision->obj0->entity_idx, collision->obj1->entity_idx);
+    phys_obj_t* obj = &phys_objs[i];
+    if (obj->rb.is_sleeping) { continue; }
+    f32 velocity = vec3_distance(PHYS_OBJ_POS(obj), PHYS_OBJ_LAST_POS(obj)) / dt;
+    obj->rb.sleep_time = velocity < phys_sleep_velocity ? obj->rb.sleep_time + dt : 0.0f;
   }
-  ARRFREE(collision_arr);
-  collision_arr_len = 0;
 
-  return;
+  phys_island_build(phys_objs, phys_objs_len, phys_objs_static_len, true);
+  u32 islands_len = 0;
+  u32 island_objs_len = 0;
+  phys_island_t* islands     = phys_island_get_arr(&islands_len);
+  u32*           island_objs = phys_island_get_objs(&island_objs_len);
+  for (u32 i = 0; i < islands_len; ++i)
+  {
+    if (islands[i].min_sleep_time < phys_sleep_time) { continue; }
+
+    phys_sleep_island_id++;
+    u32 end = islands[i].start + islands[i].len;
+    for (u32 j = islands[i].start; j < end; ++j)
+    {
+      phys_obj_t* obj = &phys_objs[island_objs[j]];
+      u32 next = island_objs[j +1 < end ? j +1 : islands[i].start];
+      obj->rb.is_sleeping  = true;
+      obj->rb.sleep_island = phys_sleep_island_id;
+      obj->rb.sleep_next   = phys_objs[next].slot_idx;
+      vec3_copy(VEC3(0), PHYS_OBJ_VELOCITY(obj));
+      vec3_copy(VEC3(0), PHYS_OBJ_FORCE(obj));
+      vec3_copy(PHYS_OBJ_POS(obj), PHYS_OBJ_LAST_POS(obj));
+    }
+  }
 }
 
-void phys_update_old(f32 dt)
+// wake obj and every obj that fell asleep together with it, only looks at the objs of its step island
+// all of them are in there, they were touching when falling asleep and havent moved since
+static void phys_wake_step_island(phys_obj_t* obj, u32* island_objs, u32 island_objs_len)
 {
-	// go through all objs
-  // skip objects that are static or not colliders
-	for (int i = 0; i < (int)phys_objs_len; ++i) 
+  if (!PHYS_OBJ_HAS_RIGIDBODY(obj) || !obj->rb.is_sleeping) { return; }
+  u32 island = obj->rb.sleep_island;
+  for (u32 i = 0; i < island_objs_len; ++i)
+  {
+    phys_obj_t* o = &phys_objs[island_objs[i]];
+    if (!o->rb.is_sleeping || o->rb.sleep_island != island) { continue; }
+    o->rb.is_sleeping = false;
+    o->rb.sleep_time  = 0.0f;
+  }
+}
+
+// check and resolve both objs of a pair, obj0 needs a rigidbody
+// checks again, pairs before it in the island might have moved the objs
+// runs on worker threads, only writes to rigidbodies in the island, rest goes in step->contacts
+static void phys_update_new_collide(phys_obj_t* obj0, phys_obj_t* obj1, phys_step_island_t* step, u32* island_objs, u32 island_objs_len)
+{
+  bool obj1_has_rb = PHYS_OBJ_HAS_RIGIDBODY(obj1);
+  bool trigger     = obj0->collider.is_trigger || obj1->collider.is_trigger;
+
+  // sleeping objs only get checked against awake rigidbodies and triggers
+  if (!trigger && obj0->rb.is_sleeping && (!obj1_has_rb || obj1->rb.is_sleeping)) { return; }
+
+	collision_info_t c = phys_collision_check(obj0, obj1);
+  if (!c.collision) { return; }
+
+  // notify objects of collision
+  c.trigger = trigger;
+
+  // awake obj ran into a sleeping one
+  if (!c.trigger)
+  {
+    phys_wake_step_island(obj0, island_objs, island_objs_len);
+    phys_wake_step_island(obj1, island_objs, island_objs_len);
+  }
+
+  phys_step_contact_t contact = { .obj0 = (int)(obj0 - phys_objs), .obj1 = (int)(obj1 - phys_objs), .c = c };
+  step->contacts[step->contacts_len++] = contact;
+
+  if (!c.trigger) // no response on trigger collisions
+  { phys_collision_resolution_pair(obj0, obj1, c); }
+
+  // after resolution, it uses whether they were grounded before this pair
+  // obj1 is grounded if obj0 got pushed straight down, static obj1 gets set in phys_update_new_flush()
+  obj0->collider.is_colliding = true;
+  obj0->collider.is_grounded  = obj0->collider.is_grounded || c.grounded;
+  if (!obj1_has_rb) { return; }
+  obj1->collider.is_colliding = true;
+  obj1->collider.is_grounded  = obj1->collider.is_grounded || 
+                                (c.direction[0] == 0.0f && c.direction[2] == 0.0f && c.direction[1] * c.depth < 0.0f);
+}
+
+// data for phys_update_new_island_job()
+typedef struct
+{
+  phys_obj_combination_t* pairs;
+  phys_island_t*          islands;
+  u32*                    island_objs;
+}phys_step_job_t;
+
+// resolving earlier pairs in an island can push objs into each other
+// objs get pushed about as far as they moved this step, so keep pairs at least that close
+static bool phys_update_new_near(phys_obj_t* obj0, phys_obj_t* obj1)
+{
+  f32 margin = vec3_distance(PHYS_OBJ_POS(obj0), PHYS_OBJ_LAST_POS(obj0)) + PHYS_CONTACT_MARGIN;
+  if (PHYS_OBJ_HAS_RIGIDBODY(obj1)) { margin += vec3_distance(PHYS_OBJ_POS(obj1), PHYS_OBJ_LAST_POS(obj1)); }
+
+  vec3 min0, max0, min1, max1;
+  phys_broadphase_obj_aabb(obj0, min0, max0);
+  phys_broadphase_obj_aabb(obj1, min1, max1);
+  vec3_sub_f(min0, margin, min0);
+  vec3_add_f(max0, margin, max0);
+  return phys_bvh_aabb_overlap(min0, max0, min1, max1);
+}
+
+// find touching or nearly touching pairs, before any resolution, so all pairs can be split across threads
+// islands only recheck these, most pairs from the broadphase dont touch
+static void phys_update_new_narrowphase_job(u32 start, u32 end, u32 thread_idx, void* data)
+{
+  (void)thread_idx;
+  phys_obj_combination_t* pairs = data;
+  for (u32 i = start; i < end; ++i)
+  {
+    phys_narrow_touching_arr[i] = 0;
+    phys_obj_t* obj0 = &phys_objs[pairs[i].a];
+    phys_obj_t* obj1 = &phys_objs[pairs[i].b];
+    bool obj1_has_rb = PHYS_OBJ_HAS_RIGIDBODY(obj1);
+    bool trigger     = obj0->collider.is_trigger || obj1->collider.is_trigger;
+
+    if (!trigger && obj0->rb.is_sleeping && !obj1_has_rb) { continue; }
+    if (!trigger && obj0->rb.is_sleeping && obj1->rb.is_sleeping)
+    {
+      // keeps objs that fell asleep together in one island, waking one wakes all of them
+      if (obj0->rb.sleep_island == obj1->rb.sleep_island) 
+      { phys_narrow_touching_arr[i] = 1; }
+      continue;
+    }
+    if (!phys_collision_check(obj0, obj1).collision && !phys_update_new_near(obj0, obj1)) { continue; }
+    phys_narrow_touching_arr[i] = 1;
+  }
+}
+
+// dynamics on the packed arrs of the rigidbodies, see phys_bodies_t
+// start and end are rigidbody idx's
+static void phys_update_new_dynamics_job(u32 start, u32 end, u32 thread_idx, void* data)
+{
+  (void)thread_idx;
+  f32 dt = *(f32*)data;
+	for (u32 i = phys_objs_static_len + start; i < phys_objs_static_len + end; ++i) 
 	{
     phys_obj_t* obj0 = &phys_objs[i];
+    // drag uses is_colliding from last step, like phys_dynamics_simulate()
+    bool has_collider = PHYS_OBJ_HAS_COLLIDER(obj0);
+    phys_bodies.drag[i]        = has_collider && obj0->collider.is_colliding ? obj0->rb.drag * obj0->rb.friction : obj0->rb.drag;
+    phys_bodies.is_sleeping[i] = obj0->rb.is_sleeping;
 
-    // ---- dynamics ----
-		if (!PHYS_OBJ_HAS_RIGIDBODY(obj0)) { continue; }
-    phys_dynamics_simulate(obj0, dt);
-
-		// ---- collision ----
-		if (!PHYS_OBJ_HAS_COLLIDER(obj0)) { continue; }
-    
+    // keeps is_colliding / is_grounded from when it fell asleep
+    if (obj0->rb.is_sleeping || !has_collider) { continue; }
     obj0->collider.is_colliding = false; 
 	  obj0->collider.is_grounded  = false; 	
+  }
+  phys_dynamics_simulate_bodies(&phys_bodies, phys_objs_static_len + start, phys_objs_static_len + end, dt);
+}
+
+static void phys_update_new_island_job(u32 start, u32 end, u32 thread_idx, void* data)
+{
+  (void)thread_idx;
+  phys_step_job_t* job = data;
+  for (u32 i = start; i < end; ++i)
+  {
+    phys_step_island_t* step   = &phys_step_island_arr[i];
+    u32*                objs   = job->island_objs + job->islands[i].start;
+    u32                 objs_len = job->islands[i].len;
+    u32*                pairs  = phys_step_pair_arr + step->pairs_start;
+    step->contacts_len = 0;
 
-    // test with all other colliders
-		for (int j = 0; j < (int)phys_objs_len; ++j) // array of colliders
-		{
-			if (j == i) { continue; }
-			// if (j == i) { break; } // this would ensure all combinations only get checked once
-		  if (!PHYS_OBJ_HAS_COLLIDER(obj0)) { continue; }
-      phys_obj_t* obj1 = &phys_objs[j];
-
-			collision_info_t c = phys_collision_check(obj0, obj1);
-      obj0->collider.is_colliding = obj0->collider.is_colliding || c.collision;
-      obj0->collider.is_grounded  = obj0->collider.is_grounded  || c.grounded;
-      
-      // ---- collision response ----
-		  if (c.collision)
-		  {
-		  	// notify objects of collision
-		  	c.trigger = obj0->collider.is_trigger || obj1->collider.is_trigger;
-
-		  	c.obj_idx = obj1->entity_idx;
-		  	arrput(obj0->collider.infos, c);
-		  	obj0->collider.infos_len++;
-
-		  	c.obj_idx = obj0->entity_idx;
-		  	arrput(obj1->collider.infos, c);
-		  	obj1->collider.infos_len++;
-
-		    if (!c.trigger && PHYS_OBJ_HAS_RIGIDBODY(obj0)) // no response on trigger collisions
-		  	{
-          // P_INT(obj1->entity_idx);
-		  		phys_collision_resolution(obj0, obj1, c);
-          COLLISION_CALLBACK(obj0->entity_idx, obj1->entity_idx);
-		  	}
-        else if (PHYS_OBJ_HAS_RIGIDBODY(obj0))
-        {
-          TRIGGER_CALLBACK(obj0->entity_idx, obj1->entity_idx);
-        }
-		  }
-      // vec3 p0;
-      // vec3 p1;
-      // vec3 p2;
-      // if (phys_collision_check_aabb_v_triangle(obj0->pos, obj0->collider.box.aabb[1], p0, p1, p2) )
-      // {
-      //   obj0->rb.force[1] += 200.0f;
-      // }
-
-      #ifdef TERRAIN_ADDON
-      
-      // @TMP:
-      if (obj0->collider.type != PHYS_COLLIDER_BOX) { continue; }
-      
-      // terrain collision
-      for (int chunk_idx = 0; chunk_idx < (int)core_data->terrain_chunks_len; ++chunk_idx) 
+    // rigidbody v static first, so objs resting on static objs are grounded
+    // before rigidbody v rigidbody, which doesnt push grounded objs into the ground
+    for (u32 j = 0; j < step->pairs_len; ++j) 
+    {
+      phys_obj_combination_t* p = &job->pairs[pairs[j]];
+      if (PHYS_OBJ_HAS_RIGIDBODY(&phys_objs[p->b])) { continue; }
+      phys_update_new_collide(&phys_objs[p->a], &phys_objs[p->b], step, objs, objs_len);
+    }
+    for (u32 j = 0; j < step->pairs_len; ++j) 
+    {
+      phys_obj_combination_t* p = &job->pairs[pairs[j]];
+      if (!PHYS_OBJ_HAS_RIGIDBODY(&phys_objs[p->b])) { continue; }
+      phys_update_new_collide(&phys_objs[p->a], &phys_objs[p->b], step, objs, objs_len);
+    }
+  }
+}
+
+// apply contacts of all islands in island order, so events and callbacks dont depend on the threads
+static void phys_update_new_flush(u32 islands_len)
+{
+  phys_island_begin();
+  for (u32 i = 0; i < islands_len; ++i)
+  {
+    phys_step_island_t* step = &phys_step_island_arr[i];
+    for (u32 j = 0; j < step->contacts_len; ++j)
+    {
+      phys_step_contact_t* contact = &step->contacts[j];
+      phys_obj_t* obj0 = &phys_objs[contact->obj0];
+      phys_obj_t* obj1 = &phys_objs[contact->obj1];
+      collision_info_t c = contact->c;
+      bool obj1_has_rb = PHYS_OBJ_HAS_RIGIDBODY(obj1);
+
+      phys_contacts_report(obj0, obj1, &c);
+
+      if (!c.trigger)
+      {
+        if (obj1_has_rb && phys_sleep_enabled)
+        { phys_island_add_contact(contact->obj0, contact->obj1); }
+        COLLISION_CALLBACK(obj0->entity_idx, obj1->entity_idx);
+      }
+      else
       {
+        TRIGGER_CALLBACK(obj0->entity_idx, obj1->entity_idx);
+      }
 
-        if (!core_data->terrain_chunks[chunk_idx].loaded || !core_data->terrain_chunks[chunk_idx].visible) { continue; }
-        terrain_chunk_t* chunk = &core_data->terrain_chunks[chunk_idx];
-
-        // get collider_position using cam_pos
-        // map cam-pos to 0.0 <-> 1.0 range inside the chunk
-        f32 x = ( obj0->pos[0] + ( core_data->terrain_scl * 0.5f));
-        f32 z = ( obj0->pos[2] + ( core_data->terrain_scl * 0.5f));
-        f32 col_x_len = (f32)core_data->terrain_collider_positions_x_len;
-        f32 col_z_len = (f32)core_data->terrain_collider_positions_z_len;
-        f32 x_perc = ( x / core_data->terrain_scl );
-        f32 z_perc = ( z / core_data->terrain_scl );
-        if (x_perc > 1.0f || x_perc < 0.0f || z_perc > 1.0f || z_perc < 0.0f) { continue; }
-        // PF("%.2f, %.2f\n", x_perc, z_perc);
-        
-        // 1. map 0.0<->1,0 to the positions arrays length's in both dimesnions
-        // 2. take those two numbers and turn them into idx for the one dimensional array
-        // floor(x +0.5): 1.49 -> 1.0, 1.51 -> 2.0
-        int x_idx = (int)floor( (x_perc * col_x_len) + 0.5f );
-        int z_idx = (int)floor( (z_perc * col_z_len) + 0.5f );
-        // int x_idx = (int)floor( (x_perc * col_x_len) );
-        // int z_idx = (int)floor( (z_perc * col_z_len) );
-        // int x_idx = (int)ceil( (x_perc * col_x_len) );
-        // int z_idx = (int)ceil( (z_perc * col_z_len) );
-        int idx = x_idx + (z_idx * (int)core_data->terrain_collider_positions_z_len);
-
-        int x_len = (int)core_data->terrain_collider_positions_x_len;
-        int z_len = (int)core_data->terrain_collider_positions_z_len;
-        // right / +x
-        bool right = ((idx+1) % x_len == 0);
-        idx -= right * 1;
-        // left / -x
-        bool left = (idx % x_len == 0);
-        idx += left * 1;
-        // bottom / -z
-        bool bottom = (idx < x_len);
-        idx += bottom * x_len;
-        // top  / +z
-        bool top = (idx + x_len >= x_len * z_len);
-        idx -= top * x_len;
-        
-        // pos1 = &chunk->collider_points[((u32)idx + core_data->terrain_collider_positions_x_len-1) *3];
-        // pos2 = &chunk->collider_points[((u32)idx + core_data->terrain_collider_positions_x_len) *3];
-        // pos1 = &chunk->collider_points[(idx - 1) *3];
-        // pos2 = &chunk->collider_points[((u32)idx + core_data->terrain_collider_positions_x_len-1) *3];
-        // pos1 = &chunk->collider_points[((u32)idx + core_data->terrain_collider_positions_x_len   ) *3];
-        // pos2 = &chunk->collider_points[((u32)idx + core_data->terrain_collider_positions_x_len +1) *3];
-        // pos1 = &chunk->collider_points[((u32)idx + core_data->terrain_collider_positions_x_len +1) *3];
-        // pos2 = &chunk->collider_points[((u32)idx +1) *3];
-        // pos1 = &chunk->collider_points[((u32)idx +1) *3];
-        // pos2 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len +1) *3];
-        // pos1 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len +1) *3];
-        // pos2 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len) *3];
-        // pos1 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len) *3];
-        // pos2 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len -1) *3];
-        // pos1 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len -1) *3];
-        // pos2 = &chunk->collider_points[((u32)idx - 1) *3];
-        
-        f32* p0 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len -1) *3];
-        f32* p1 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len)    *3];
-        f32* p2 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len +1) *3];
-        f32* p3 = &chunk->collider_points[((u32)idx -1) *3];
-        f32* p4 = &chunk->collider_points[           idx*3];
-        f32* p5 = &chunk->collider_points[((u32)idx +1) *3];
-        f32* p6 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len -1) *3];
-        f32* p7 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len)    *3];
-        f32* p8 = &chunk->collider_points[((u32)idx - core_data->terrain_collider_positions_x_len +1) *3];
-        debug_draw_sphere(p4, 0.3f, RGB_F(0, 1, 1)); 
-        f32 dist = 0.0f;
-        if ( phys_collision_check_aabb_v_terrain_obj(obj0, p0, p1, p2, p3, p4, p5, p6, p7, p8, &dist) )
-        {
-          obj0->pos[1] += dist;
-          obj0->rb.velocity[1] = 0.0f;
-          obj0->rb.force[1] *= -1.5f;
-        }
-	    }
-      #endif // TERRAIN_ADDON
-		}
-	}
+      if (obj1_has_rb) { continue; }
+      obj1->collider.is_colliding = true;
+      obj1->collider.is_grounded  = obj1->collider.is_grounded || 
+                                    (c.direction[0] == 0.0f && c.direction[2] == 0.0f && c.direction[1] * c.depth < 0.0f);
+    }
+  }
+}
+
+void phys_update_new(f32 dt)
+{
+  phys_contacts_begin_step();
+
+  // ---- dynamics ----
+  phys_threads_run(phys_objs_len - phys_objs_static_len, PHYS_DYNAMICS_CHUNK, phys_update_new_dynamics_job, &dt);
+
+  // ---- broadphase ----
+  // pairs are cached across frames, a always has a rigidbody
+  phys_broadphase_update(phys_objs, phys_objs_len, phys_objs_static_len);
+  u32 pairs_len = 0;
+  phys_obj_combination_t* pairs = phys_broadphase_get_pairs(&pairs_len);
+
+  // ---- narrowphase ----
+  phys_narrow_touching_arr = PHYS_ARENA_ALLOC_ARR(&phys_frame_arena, u8, pairs_len);
+  phys_threads_run(pairs_len, PHYS_NARROWPHASE_CHUNK, phys_update_new_narrowphase_job, pairs);
+  phys_contact_pair_arr     = PHYS_ARENA_ALLOC_ARR(&phys_frame_arena, u32, pairs_len);
+  phys_contact_pair_arr_len = 0;
+  for (u32 i = 0; i < pairs_len; ++i)
+  {
+    if (phys_narrow_touching_arr[i]) { phys_contact_pair_arr[phys_contact_pair_arr_len++] = i; }
+  }
+
+  // ---- islands ----
+  // rigidbodies connected by touching pairs, static objs dont connect islands
+  // includes sleeping ones, so waking them stays inside the island
+  phys_island_begin();
+	for (u32 i = 0; i < phys_contact_pair_arr_len; ++i) 
+	{
+    phys_obj_combination_t* p = &pairs[phys_contact_pair_arr[i]];
+    if (!PHYS_OBJ_HAS_RIGIDBODY(&phys_objs[p->b])) { continue; }
+    phys_island_add_contact(p->a, p->b);
+  }
+  phys_island_build(phys_objs, phys_objs_len, phys_objs_static_len, false);
+  u32 islands_len = 0;
+  u32 island_objs_len = 0;
+  u32 obj_islands_len = 0;
+  phys_island_t* islands     = phys_island_get_arr(&islands_len);
+  u32*           island_objs = phys_island_get_objs(&island_objs_len);
+  int*           obj_islands = phys_island_get_obj_islands(&obj_islands_len);
+
+  // sort touching pairs by island of a, counting sort keeps pair order inside islands
+  phys_step_island_arr = PHYS_ARENA_ALLOC_ARR(&phys_frame_arena, phys_step_island_t, islands_len);
+  for (u32 i = 0; i < islands_len; ++i)
+  { phys_step_island_arr[i].pairs_len = 0; }
+	for (u32 i = 0; i < phys_contact_pair_arr_len; ++i) 
+  { phys_step_island_arr[obj_islands[pairs[phys_contact_pair_arr[i]].a - (int)phys_objs_static_len]].pairs_len++; }
+  phys_step_contact_t* contacts = PHYS_ARENA_ALLOC_ARR(&phys_frame_arena, phys_step_contact_t, phys_contact_pair_arr_len);
+  u32 start = 0;
+  for (u32 i = 0; i < islands_len; ++i)
+  {
+    phys_step_island_arr[i].pairs_start  = start;
+    phys_step_island_arr[i].contacts     = contacts + start;
+    phys_step_island_arr[i].contacts_len = 0;
+    start += phys_step_island_arr[i].pairs_len;
+    phys_step_island_arr[i].pairs_len = 0;
+  }
+  phys_step_pair_arr = PHYS_ARENA_ALLOC_ARR(&phys_frame_arena, u32, phys_contact_pair_arr_len);
+	for (u32 i = 0; i < phys_contact_pair_arr_len; ++i) 
+  { 
+    u32 pair = phys_contact_pair_arr[i];
+    phys_step_island_t* step = &phys_step_island_arr[obj_islands[pairs[pair].a - (int)phys_objs_static_len]];
+    phys_step_pair_arr[step->pairs_start + step->pairs_len++] = pair;
+  }
+
+	// ---- collision ----
+  phys_step_job_t job = { .pairs = pairs, .islands = islands, .island_objs = island_objs };
+  phys_threads_run(islands_len, PHYS_ISLANDS_CHUNK, phys_update_new_island_job, &job);
+  phys_update_new_flush(islands_len);
+
+  #ifdef TERRAIN_ADDON
+	for (u32 i = phys_objs_static_len; i < phys_objs_len; ++i) 
+	{
+    phys_obj_t* obj0 = &phys_objs[i];
+		if (!PHYS_OBJ_HAS_COLLIDER(obj0) || obj0->rb.is_sleeping) { continue; }
+    phys_update_old_terrain(obj0);
+  }
+  #endif // TERRAIN_ADDON
+
+  // ---- sleeping ----
+  phys_update_sleep(dt);
+
+  // resolution moved rigidbodies since the broadphase, queries until the next step need them in the tree
+  phys_broadphase_update_aabbs(phys_objs, phys_objs_len, phys_objs_static_len);
+
+  phys_contacts_end_step();
 }
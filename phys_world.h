@@ -3,6 +3,8 @@
 
 #include "global/global.h"
 #include "phys/phys_types.h"
+#include "phys/phys_bodies.h"
+#include "phys/phys_arena.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,26 +30,104 @@ typedef struct
   collision_info_t c;
 }phys_collision_t;
 
+// @DOC: what happened to a contact in the last step, see phys_contact_event_t
+typedef enum phys_contact_event_type
+{
+  PHYS_CONTACT_BEGIN, // started touching this step
+  PHYS_CONTACT_STAY,  // touched last step as well, sleeping contacts dont send this
+  PHYS_CONTACT_END,   // stopped touching, or one of the objs got removed
+
+}phys_contact_event_type;
+
+// @DOC: contact between two objs, at least one with PHYS_REPORT_CONTACTS
+//       see phys_get_contact_events()
+typedef struct
+{
+  phys_contact_event_type type;
+  int entity0;          // entity_idx of obj0, always has a rigidbody
+  int entity1;          // entity_idx of obj1
+  phys_handle_t obj0;   // removed on PHYS_CONTACT_END if the obj got removed
+  phys_handle_t obj1;
+  collision_info_t c;   // direction from obj0's view, only collision false on PHYS_CONTACT_END
+
+}phys_contact_event_t;
+
 
-// @DOC: gen every combination of objs
-//       so only have to check collision once per combination
-void phys_generate_combinations();
+// @DOC: settings passed to phys_init_settings()
+typedef struct
+{
+  phys_broadphase_type broadphase;  // how overlapping pairs get found, switch later with phys_broadphase_set_type()
+  f32 grid_cell_size;               // cell size for PHYS_BROADPHASE_GRID, about the size of the average rigidbody
+  phys_static_type static_type;     // structure for static objs, switch later with phys_broadphase_set_static_type()
+  int octree_max_depth;             // deepest level for PHYS_STATIC_OCTREE, max PHYS_OCTREE_MAX_DEPTH
+  u32 octree_leaf_capacity;         // octree nodes with more objs than this get split
+  bool sleep;                       // let rigidbodies at rest fall asleep, skips their dynamics and collision checks
+  f32 sleep_velocity;               // rigidbodies moving slower than this count as resting
+  f32 sleep_time;                   // how long all rigidbodies in an island need to rest before it falls asleep
+  u32 threads;                      // threads stepping islands, including the calling thread, 0 or 1 for none
+  bool strict_math;                 // no fma in the simd dynamics, same result on every cpu, see phys_dynamics_set_strict()
+  u32 contact_events_max;           // capacity of the contact event buffer, more events per step get dropped
+  f32 fixed_dt;                     // > 0 steps in fixed steps of this length, see phys_update(), 0 steps with the dt passed
+  u32 max_substeps;                 // most fixed steps per phys_update(), time past that gets dropped
+
+}phys_settings_t;
+// @DOC: default values for phys_settings_t, used by phys_init()
+#define PHYS_SETTINGS_T_INIT()                  \
+{                                               \
+  .broadphase           = PHYS_BROADPHASE_BVH,  \
+  .grid_cell_size       = 4.0f,                 \
+  .static_type          = PHYS_STATIC_BVH,      \
+  .octree_max_depth     = 8,                    \
+  .octree_leaf_capacity = 8,                    \
+  .sleep                = true,                 \
+  .sleep_velocity       = 0.1f,                 \
+  .sleep_time           = 0.5f,                 \
+  .threads              = 1,                    \
+  .strict_math          = true,                 \
+  .contact_events_max   = 1024,                 \
+  .fixed_dt             = 0.0f,                 \
+  .max_substeps         = 4,                    \
+}
 
 // @DOC: initialize physics engine, set callbacks, or NULL, call before any oher calls to phys
 //       _collision_callback: NULL or gets called on collision
 //       _trigger_callback:   NULL or gets called on trigger collision
 void phys_init(phys_internal_collision_callback* _collision_callback, phys_internal_trigger_callback* _trigger_callback);
+// @DOC: same as phys_init(), but with settings
+//       _collision_callback: NULL or gets called on collision
+//       _trigger_callback:   NULL or gets called on trigger collision
+//       settings:            see phys_settings_t, NULL for PHYS_SETTINGS_T_INIT()
+void phys_init_settings(phys_internal_collision_callback* _collision_callback, phys_internal_trigger_callback* _trigger_callback, phys_settings_t* settings);
 
 // @DOC: call once a frame to update the state of the physics engine
+//       with phys_settings_t.fixed_dt 0 it does one step of dt
+//       otherwise dt gets added to an accumulator and as many steps of fixed_dt as fit get done
+//       at most phys_settings_t.max_substeps, so a long frame doesnt cause longer and longer frames
+//       the rest is left for the next call, see phys_get_interp_alpha()
 //       dt: pass delta time, the time passed since last frame
 void phys_update(f32 dt);
+// @DOC: set fixed step length and max steps per phys_update(), resets the accumulator
+//       fixed_dt:     length of one step, 0 to step with the dt passed to phys_update()
+//       max_substeps: most steps per phys_update(), at least 1
+void phys_set_fixed_timestep(f32 fixed_dt, u32 max_substeps);
+// @DOC: get how far the accumulator is into the next fixed step, 0 - 1
+//       to draw objs between their pos before and after the last step, see phys_get_interp_pos()
+//       always 1 without phys_settings_t.fixed_dt
+f32 phys_get_interp_alpha();
+// @DOC: get number of steps done in the last phys_update(), can be 0 with phys_settings_t.fixed_dt
+u32 phys_get_substeps();
 
-// @DOC: only checks every possible combination
+// @DOC: checks every overlapping pair once, resolving both objs
+//       pairs come from the broadphase's pair cache, used by phys_update()
+//       pairs get grouped into islands, which get stepped on the worker threads
+//       see phys_settings_t.threads, result doesnt depend on the number of threads
+//       callbacks get called on the calling thread, after all islands are done
 void phys_update_new(f32 dt);
 
 // @DOC: checks every obj against every other obj
 //       meanind does both 
 //       obj[1] v obj[2] and obj[2] v obj[1]
+//       doesnt put objs to sleep, but skips the ones phys_update() put to sleep
 void phys_update_old(f32 dt);
 
 
@@ -59,37 +139,180 @@ void phys_obj_make_box(vec3 aabb[2], vec3 offset, bool is_trigger, phys_obj_t* o
 
 // @DOC: add physics object with rigidbody, but no collider
 //       entity_id: id of entity to attach to
-void phys_add_obj_rb(int entity_idx, vec3 pos, f32 mass, f32 friction);
+//       returns handle to the obj, see phys_get_obj()
+phys_handle_t phys_add_obj_rb(int entity_idx, vec3 pos, f32 mass, f32 friction);
 // @DOC: add physics object with box collider but no rigidbody
 //       entity_id: id of entity to attach to
 //       aabb: aabb[0] is min, aabb[1] is max
-void phys_add_obj_box(int entity_idx, vec3 pos, vec3 scl, vec3 aabb[2], vec3 offset, bool is_trigger);
+//       returns handle to the obj, see phys_get_obj()
+phys_handle_t phys_add_obj_box(int entity_idx, vec3 pos, vec3 scl, vec3 aabb[2], vec3 offset, bool is_trigger);
 // @DOC: add physics object with sphere collider but no rigidbody
 //       entity_id: id of entity to attach to
-void phys_add_obj_sphere(int entity_idx, vec3 pos, vec3 scl, f32 radius, vec3 offset, bool is_trigger);
+//       returns handle to the obj, see phys_get_obj()
+phys_handle_t phys_add_obj_sphere(int entity_idx, vec3 pos, vec3 scl, f32 radius, vec3 offset, bool is_trigger);
 // @DOC: add physics object with box collider and rigidbody
 //       entity_id: id of entity to attach to
 //       aabb: aabb[0] is min aabb[1] is max
-void phys_add_obj_rb_box(int entity_idx, vec3 pos, vec3 scl, f32 mass, f32 friction, vec3 aabb[2], vec3 offset, bool is_trigger);
+//       returns handle to the obj, see phys_get_obj()
+phys_handle_t phys_add_obj_rb_box(int entity_idx, vec3 pos, vec3 scl, f32 mass, f32 friction, vec3 aabb[2], vec3 offset, bool is_trigger);
 // @DOC: add phys obj with rigidbody and sphere collider
 //       entity_id: id of entity to attach to
-void phys_add_obj_rb_sphere(int entity_idx, vec3 pos, vec3 scl, f32 mass, f32 friction, f32 radius, vec3 offset, bool is_trigger);
+//       returns handle to the obj, see phys_get_obj()
+phys_handle_t phys_add_obj_rb_sphere(int entity_idx, vec3 pos, vec3 scl, f32 mass, f32 friction, f32 radius, vec3 offset, bool is_trigger);
+
+// @DOC: describes one obj for phys_add_objs()
+typedef struct
+{
+  int  entity_idx;      // id of entity to attach to
+  vec3 pos;
+  vec3 scl;
+  phys_obj_flag flags;  // PHYS_HAS_RIGIDBODY and / or PHYS_HAS_BOX or PHYS_HAS_SPHERE, PHYS_REPORT_CONTACTS
+  f32  mass;            // only with PHYS_HAS_RIGIDBODY
+  f32  friction;        // only with PHYS_HAS_RIGIDBODY
+  vec3 aabb[2];         // only with PHYS_HAS_BOX, aabb[0] is min, aabb[1] is max
+  f32  radius;          // only with PHYS_HAS_SPHERE
+  vec3 offset;          // collider offset
+  bool is_trigger;
+  u32  layer;           // collision layer, see phys_obj_t.layer
+  u32  layer_mask;      // layers it collides with, see phys_obj_t.layer_mask
+
+}phys_obj_desc_t;
+// @DOC: default values for phys_obj_desc_t, static box of size 1
+#define PHYS_OBJ_DESC_T_INIT()                                      \
+{                                                                   \
+  .entity_idx = -1,                                                 \
+  .pos        = { 0, 0, 0 },                                        \
+  .scl        = { 1, 1, 1 },                                        \
+  .flags      = PHYS_HAS_BOX,                                       \
+  .mass       = 1.0f,                                               \
+  .friction   = 0.1f,                                               \
+  .aabb       = { { -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f } },  \
+  .radius     = 0.5f,                                               \
+  .offset     = { 0, 0, 0 },                                        \
+  .is_trigger = false,                                              \
+  .layer      = PHYS_LAYER_DEFAULT,                                 \
+  .layer_mask = PHYS_LAYER_MASK_ALL,                                \
+}
+
+// @DOC: add many objs at once, i.e. when loading a level
+//       reserves memory once, the static structure gets built once on the next update
+//       same result as calling phys_add_obj_...() for every desc
+//       descs:       objs to add
+//       descs_len:   number of descs
+//       handles_out: NULL or arr with descs_len handles, gets the handle of each desc
+void phys_add_objs(phys_obj_desc_t* descs, u32 descs_len, phys_handle_t* handles_out);
 
   // @DOC: remove object, by the entity its attached to
 //       entity_idx: phys obj with phys_obj_t.entity_idx == entity_idx gets removed
 void phys_remove_obj(int entity_idx);
+// @DOC: remove object, by the handle returned when adding it, doesnt search the objs
+//       does nothing if h was already removed
+//       h: handle of obj to remove, gets invalid
+void phys_remove_obj_handle(phys_handle_t h);
+// @DOC: get obj by handle, returns NULL if the obj was removed
+//       only valid until objs get added / removed, keep the handle not the pointer
+//       h: handle returned by phys_add_obj_...()
+phys_obj_t* phys_get_obj(phys_handle_t h);
 
 // @DOC: 'roatate' aabb 90° around y
 //       entity_idx: phys obj with phys_obj_t.entity_idx == entity_idx gets rotated
 void phys_rotate_box_y(int entity_idx);
 
 
-// @DOC: remove all objects
+// @DOC: wake up sleeping rigidbody and every obj that fell asleep together with it
+//       call after changing pos or velocity of a rigidbody directly
+//       entity_idx: phys obj with phys_obj_t.entity_idx == entity_idx gets woken up
+void phys_wake(int entity_idx);
+// @DOC: add force to rigidbody, wakes it up
+//       entity_idx: phys obj with phys_obj_t.entity_idx == entity_idx gets the force
+//       force:      added to PHYS_OBJ_FORCE(), gets applied in the next phys_update()
+void phys_add_force(int entity_idx, vec3 force);
+
+// @DOC: get obj attached to entity, looked up in a hashmap, doesnt search the objs
+//       returns NULL if none, the last one added if there are multiple
+//       only valid until objs get added / removed
+//       entity_idx: phys_obj_t.entity_idx of obj
+phys_obj_t* phys_get_obj_entity(int entity_idx);
+// @DOC: get pos of obj attached to entity, returns false if there is none
+//       out: gets set to PHYS_OBJ_POS()
+bool phys_get_pos(int entity_idx, vec3 out);
+// @DOC: get pos of obj attached to entity for drawing, returns false if there is none
+//       lerp from PHYS_OBJ_LAST_POS() to PHYS_OBJ_POS() by phys_get_interp_alpha()
+//       last_pos is where the last step started, objs without rigidbody dont get interpolated
+//       out: gets set to the interpolated pos
+bool phys_get_interp_pos(int entity_idx, vec3 out);
+// @DOC: teleport all objs attached to entity, wakes objs around the old and new pos
+//       also sets last_pos, so the move doesnt count for swept collision checks
+void phys_set_pos(int entity_idx, vec3 pos);
+// @DOC: get velocity of rigidbody attached to entity, returns false if there is none
+//       out: gets set to PHYS_OBJ_VELOCITY()
+bool phys_get_velocity(int entity_idx, vec3 out);
+// @DOC: set velocity of rigidbodies attached to entity, wakes them up
+void phys_set_velocity(int entity_idx, vec3 velocity);
+// @DOC: get force of rigidbody attached to entity, returns false if there is none
+//       out: gets set to PHYS_OBJ_FORCE()
+bool phys_get_force(int entity_idx, vec3 out);
+// @DOC: set force of rigidbodies attached to entity, wakes them up, see phys_add_force()
+void phys_set_force(int entity_idx, vec3 force);
+
+// @DOC: put all objs attached to entity on a collision layer, see phys_obj_t.layer
+//       layer: 0 - PHYS_LAYERS_MAX -1
+void phys_set_layer(int entity_idx, u32 layer);
+// @DOC: set which layers all objs attached to entity collide with, see phys_obj_t.layer_mask
+//       mask: bit per layer, see PHYS_LAYER_BIT(), PHYS_LAYER_MASK_ALL by default
+void phys_set_layer_mask(int entity_idx, u32 mask);
+// @DOC: set if objs on layer0 and layer1 collide, both ways, all layers collide by default
+//       pairs that dont collide get dropped in the broadphase, before the narrowphase
+//       i.e. phys_set_layer_collision(LAYER_DEBRIS, LAYER_DEBRIS, false)
+void phys_set_layer_collision(u32 layer0, u32 layer1, bool collide);
+// @DOC: get if objs on layer0 and layer1 collide, see phys_set_layer_collision()
+bool phys_get_layer_collision(u32 layer0, u32 layer1);
+
+// @DOC: turn contact events on / off for all objs attached to entity, see phys_get_contact_events()
+//       can also be set on add with PHYS_REPORT_CONTACTS in phys_obj_desc_t.flags
+void phys_set_report_contacts(int entity_idx, bool report);
+// @DOC: get contact events of the last phys_update(), in the order they happened
+//       with phys_settings_t.fixed_dt the events of all its steps, a contact can STAY once per step
+//       only contacts with at least one obj with PHYS_REPORT_CONTACTS
+//       fixed capacity, see phys_settings_t.contact_events_max, doesnt allocate during the step
+//       len:     gets set to number of events
+//       dropped: NULL or gets set to number of events that didnt fit
+phys_contact_event_t* phys_get_contact_events(u32* len, u32* dropped);
+
+// @DOC: remove all objects, all handles get invalid
 void phys_clear_state();
 
 // @DOC: get arr with all phys_obj_t 
+//       static objs come first, then all with rigidbody, adding / removing objs can change the order
 //       len: gets set to arr's length
 phys_obj_t* phys_get_obj_arr(u32* len);
+// @DOC: get arr with all phys_obj_t without rigidbody, start of phys_get_obj_arr()
+//       static objs only get checked against rigidbodies, call phys_broadphase_refresh() after moving one
+//       len: gets set to arr's length
+phys_obj_t* phys_get_static_obj_arr(u32* len);
+// @DOC: get arr with all phys_obj_t with rigidbody, end of phys_get_obj_arr()
+//       len: gets set to arr's length
+phys_obj_t* phys_get_rb_obj_arr(u32* len);
+// @DOC: get pos, velocity, etc. of all objs, one packed arr per field, same idx as in phys_objs
+//       the rigidbodies start at the len of phys_get_static_obj_arr(), same order as phys_get_rb_obj_arr()
+//       this is the state itself, writes dont wake objs or refresh the broadphase like phys_set_pos() does
+phys_bodies_t* phys_get_bodies();
+// @DOC: get scratch memory reset at the start of every phys_update()
+//       queries use it between phys_arena_mark() and phys_arena_restore(), see phys_arena_t
+phys_arena_t* phys_get_frame_arena();
+
+// @DOC: heap allocations done by phys, see phys_get_alloc_stats()
+typedef struct
+{
+  u32 step_allocs;    // in the last phys_update(), 0 once all buffers grew large enough
+  u32 total_allocs;   // since start, see phys_alloc_count
+  u32 arena_size;     // bytes in the frame arena
+  u32 arena_peak;     // most bytes the frame arena needed since its last reset
+
+}phys_alloc_stats_t;
+// @DOC: get heap allocation counts, to check a step doesnt allocate
+//       out: gets filled
+void phys_get_alloc_stats(phys_alloc_stats_t* out);
 
 
 #ifdef __cplusplus